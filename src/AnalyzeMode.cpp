@@ -0,0 +1,118 @@
+#include <cassert>
+#include <vector>
+#include "AnalyzeMode.h"
+#include "ConfMode.h"
+#include "CMakeCommand.h"
+#include "CacheCommand.h"
+#include "ClangTimeTrace.h"
+#include "JobCount.h"
+#include "FileSystem.h"
+#include "Settings.h"
+#include "Configuration.h"
+#include "Process.h"
+#include "Helpers.h"
+
+namespace {
+
+bool checkCompiler()
+{
+	if (config().platform() != Configuration::Platform::DESKTOP)
+	{
+		Helpers::error("The compilation analysis is only available for the desktop platform");
+		return false;
+	}
+	else if (CMakeCommand::generatorIsVisualStudio())
+	{
+		Helpers::error("The compilation analysis is not available with the Visual Studio generators");
+		return false;
+	}
+#ifndef __APPLE__
+	else if (config().compiler() != Configuration::Compiler::CLANG)
+	{
+		Helpers::error("The compilation analysis needs Clang, choose it with the 'set -clang' command");
+		return false;
+	}
+#endif
+
+	return true;
+}
+
+/// The flag that makes Clang write a time trace next to every object file
+const char *timeTraceFlag = "-ftime-trace";
+
+void noCompilerLauncherArgs(std::string &cmakeArguments)
+{
+	// A compiler cache hit would not write any trace
+	cmakeArguments += " -D CMAKE_C_COMPILER_LAUNCHER= -D CMAKE_CXX_COMPILER_LAUNCHER=";
+}
+
+bool configureAndBuild(CMakeCommand &cmake, const char *srcDir, const std::string &buildDir, const std::string &arguments, const Settings &settings)
+{
+	if (cmake.configure(srcDir, buildDir.data(), arguments.data()) == false)
+		return false;
+
+	// Every translation unit is compiled again to have a complete set of traces
+	const char *buildConfig = CMakeCommand::generatorIsMultiConfig() ? Settings::buildTypeToConfigString(settings.buildType()) : nullptr;
+	cmake.build(buildDir.data(), buildConfig, "clean");
+	return cmake.build(buildDir.data(), buildConfig, nullptr);
+}
+
+void printTimeTraceReport(const std::string &buildDir, const Settings &settings)
+{
+	std::vector<std::string> files;
+	fs::listFiles(fs::joinPath(buildDir, "CMakeFiles").data(), files);
+
+	ClangTimeTrace timeTrace;
+	for (const std::string &file : files)
+	{
+		if (fs::endsWith(file, ".json"))
+			timeTrace.add(file.data());
+	}
+
+	if (timeTrace.numUnits() == 0)
+	{
+		Helpers::error("Cannot find any Clang time trace in: ", buildDir.data());
+		return;
+	}
+	timeTrace.printReport(settings.reportEntries());
+}
+
+}
+
+///////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////
+
+void AnalyzeMode::perform(CMakeCommand &cmake, CacheCommand &cache, const Settings &settings)
+{
+	assert(settings.mode() == Settings::Mode::ANALYZE);
+	assert(settings.target() != Settings::Target::LIBS);
+
+	if (checkCompiler() == false)
+		return;
+
+	std::string jobsReason;
+	cmake.setJobs(JobCount::compute(settings.jobs(), jobsReason));
+
+	std::string srcDir;
+	std::string arguments;
+	if (settings.target() == Settings::Target::ENGINE)
+	{
+		srcDir = Helpers::nCineSourceDir();
+		ConfMode::engineArguments(arguments, cmake, cache, settings, timeTraceFlag, std::string());
+	}
+	else
+	{
+		config().gameName(srcDir);
+		ConfMode::gameArguments(arguments, cmake, cache, settings, timeTraceFlag, std::string());
+	}
+	noCompilerLauncherArgs(arguments);
+
+	// A dedicated build directory, to leave the regular one and its objects untouched
+	std::string buildDir = srcDir + "-timetrace";
+	Helpers::buildDir(buildDir, settings);
+	Helpers::info("Analyze the compilation in: ", buildDir.data());
+
+	if (configureAndBuild(cmake, srcDir.data(), buildDir, arguments, settings) && Process::dryRun == false)
+		printTimeTraceReport(buildDir, settings);
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+class Settings;
+class CMakeCommand;
+class CacheCommand;
+
+class AnalyzeMode
+{
+  public:
+	static void perform(CMakeCommand &cmake, CacheCommand &cache, const Settings &settings);
+};
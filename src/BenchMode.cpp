@@ -0,0 +1,213 @@
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+#include "BenchMode.h"
+#include "BenchResults.h"
+#include "BuildHistory.h"
+#include "ConfMode.h"
+#include "GitCommand.h"
+#include "CMakeCommand.h"
+#include "CacheCommand.h"
+#include "JobCount.h"
+#include "FileSystem.h"
+#include "Settings.h"
+#include "Configuration.h"
+#include "Process.h"
+#include "Helpers.h"
+
+namespace {
+
+/// The significance level under which a difference between two runs is not attributed to noise
+const float Significance = 0.05f;
+/// The prefix of the names of the benchmark executables of the engine
+const char *benchmarkPrefix = "gbench_";
+
+bool isBenchmarkExecutable(const std::string &path)
+{
+	const std::string name = fs::baseName(path.data());
+	if (name.compare(0, strlen(benchmarkPrefix), benchmarkPrefix) != 0)
+		return false;
+
+#ifdef _WIN32
+	return (name.size() > 4 && name.compare(name.size() - 4, 4, ".exe") == 0);
+#else
+	// Skips the object files and the dependency files of the targets
+	return (name.find('.') == std::string::npos);
+#endif
+}
+
+/// Returns the command prefix that pins a benchmark to a single CPU, if the platform supports it
+std::string pinningCommand(const Settings &settings)
+{
+#ifdef __linux__
+	const unsigned int numCpus = std::thread::hardware_concurrency();
+	if (numCpus < 2 && settings.benchCpu() < 0)
+		return std::string();
+
+	// Interrupts are usually served by the first CPU, the last one is less disturbed
+	const unsigned int cpu = (settings.benchCpu() >= 0) ? static_cast<unsigned int>(settings.benchCpu()) : numCpus - 1;
+	const int MaxLength = 32;
+	char buffer[MaxLength];
+	snprintf(buffer, MaxLength, "taskset -c %u ", cpu);
+	Helpers::info("Pin the benchmarks to the CPU: ", buffer + strlen("taskset -c "));
+	return std::string(buffer);
+#else
+	if (settings.benchCpu() >= 0)
+		Helpers::error("Pinning the benchmarks to a CPU is only available on Linux");
+	return std::string();
+#endif
+}
+
+bool compareRuns(const Settings &settings)
+{
+	std::string baselineKey;
+	std::string currentKey;
+	if (BenchResults::findKey(settings.benchBaseline(), baselineKey) == false)
+	{
+		Helpers::error("Cannot find a stored benchmark run for: ", settings.benchBaseline().data());
+		return false;
+	}
+	else if (BenchResults::findKey(settings.benchCurrent(), currentKey) == false)
+	{
+		Helpers::error("Cannot find a stored benchmark run for: ", settings.benchCurrent().data());
+		return false;
+	}
+
+	BenchResults baseline;
+	BenchResults current;
+	if (baseline.load(baselineKey) == false || current.load(currentKey) == false)
+	{
+		Helpers::error("Cannot load the stored benchmark runs from: ", BenchResults::resultsDir());
+		return false;
+	}
+
+	const std::string runs = baselineKey + " -> " + currentKey;
+	Helpers::info("Compare the benchmark runs: ", runs.data());
+	return (BenchResults::compare(baseline, current, Significance) == 0);
+}
+
+}
+
+///////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////
+
+bool BenchMode::perform(GitCommand &git, CMakeCommand &cmake, CacheCommand &cache, const Settings &settings)
+{
+	assert(settings.mode() == Settings::Mode::BENCH);
+
+	if (settings.benchCompare())
+		return compareRuns(settings);
+
+	assert(settings.target() == Settings::Target::ENGINE);
+	if (config().platform() != Configuration::Platform::DESKTOP)
+	{
+		Helpers::error("The benchmarks can only run on the desktop platform");
+		return false;
+	}
+	else if (settings.repetitions() < 2)
+	{
+		Helpers::error("The benchmarks need at least two repetitions to be compared");
+		return false;
+	}
+
+	std::string engineHead;
+	if (git.retrieveHead(Helpers::nCineSourceDir(), engineHead) == false)
+	{
+		Helpers::error("Cannot retrieve the commit of the engine repository: ", Helpers::nCineSourceDir());
+		return false;
+	}
+
+	std::string jobsReason;
+	cmake.setJobs(JobCount::compute(settings.jobs(), jobsReason));
+
+	// The benchmarks are kept apart from the development builds, which do not compile them
+	std::string buildDir = Helpers::nCineSourceDir() + std::string("-bench");
+	Helpers::buildDir(buildDir, settings);
+
+	std::string arguments;
+	ConfMode::engineArguments(arguments, cmake, cache, settings);
+	arguments += " -D NCINE_BUILD_BENCHMARKS=ON";
+
+	Helpers::info("Configure and build the engine benchmarks in: ", buildDir.data());
+	const char *buildConfig = CMakeCommand::generatorIsMultiConfig() ? Settings::buildTypeToConfigString(settings.buildType()) : nullptr;
+	if (cmake.configure(Helpers::nCineSourceDir(), buildDir.data(), arguments.data()) == false ||
+	    cmake.build(buildDir.data(), buildConfig, nullptr) == false)
+	{
+		Helpers::error("Cannot build the engine benchmarks");
+		return false;
+	}
+
+	std::vector<std::string> files;
+	fs::listFiles(fs::joinPath(buildDir, "benchmarks").data(), files);
+	std::vector<std::string> executables;
+	for (const std::string &file : files)
+	{
+		if (isBenchmarkExecutable(file))
+			executables.push_back(file);
+	}
+	if (executables.empty() && Process::dryRun == false)
+	{
+		Helpers::error("No benchmark executables found in: ", fs::joinPath(buildDir, "benchmarks").data());
+		return false;
+	}
+
+	const std::string pinning = pinningCommand(settings);
+	BenchResults results;
+	bool succeeded = true;
+	for (const std::string &executable : executables)
+	{
+		const std::string jsonFile = executable + ".json";
+		std::string command = pinning + "\"" + executable + "\"";
+		command += " --benchmark_repetitions=" + std::to_string(settings.repetitions());
+		command += " --benchmark_out=\"" + jsonFile + "\" --benchmark_out_format=json";
+		if (settings.benchFilter().empty() == false)
+			command += " --benchmark_filter=\"" + settings.benchFilter() + "\"";
+
+		if (Process::executeCommand(command.data()) == false)
+		{
+			Helpers::error("The benchmark has failed: ", executable.data());
+			succeeded = false;
+		}
+		else if (Process::dryRun == false && results.addJsonFile(jsonFile.data()) == false)
+		{
+			Helpers::error("Cannot read the benchmark results: ", jsonFile.data());
+			succeeded = false;
+		}
+	}
+
+	if (Process::dryRun)
+		return true;
+	else if (results.numBenchmarks() == 0)
+	{
+		Helpers::error("The benchmarks have not written any result");
+		return false;
+	}
+
+	// Local changes make the commit alone an incomplete description of the measured code
+	std::string key = engineHead;
+	if (git.hasLocalChanges(Helpers::nCineSourceDir()))
+		key += "-dirty";
+	key += std::string("-") + BuildHistory::compilerToString() + "-" + Settings::buildTypeToString(settings.buildType());
+	// Results of builds with different unity build, precompiled header or link-time optimization settings are not comparable
+	const std::string options = BuildHistory::optionsToString(settings);
+	if (options.empty() == false)
+		key += "-" + options;
+
+	const std::string makeDirCommand = std::string("make_directory ") + BenchResults::resultsDir();
+	if (cmake.toolsMode(makeDirCommand.data()) == false || results.save(key) == false)
+	{
+		Helpers::error("Cannot store the benchmark results: ", BenchResults::resultsFile(key).data());
+		return false;
+	}
+
+	const int MaxLength = 256;
+	char buffer[MaxLength];
+	snprintf(buffer, MaxLength, "%u benchmarks with %u repetitions as: %s", results.numBenchmarks(), settings.repetitions(), key.data());
+	Helpers::info("Store ", buffer);
+	Helpers::info("Compare them with another run with the 'bench compare <baseline> ", (key + "' command").data());
+
+	return succeeded;
+}
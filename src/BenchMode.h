@@ -0,0 +1,13 @@
+#pragma once
+
+class Settings;
+class GitCommand;
+class CMakeCommand;
+class CacheCommand;
+
+class BenchMode
+{
+  public:
+	/// Returns false if the benchmarks could not be run or a comparison found significant regressions
+	static bool perform(GitCommand &git, CMakeCommand &cmake, CacheCommand &cache, const Settings &settings);
+};
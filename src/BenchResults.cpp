@@ -0,0 +1,281 @@
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include "BenchResults.h"
+#include "JsonValue.h"
+#include "FileSystem.h"
+#include "Helpers.h"
+
+namespace {
+
+const char *header = "# ncline benchmark results v1";
+const char *extension = ".tsv";
+/// Changes smaller than this percentage are not reported, even when significant
+const double MinRelativeChange = 1.0;
+
+double unitToNanoseconds(const std::string &unit)
+{
+	if (unit == "us")
+		return 1.0e3;
+	else if (unit == "ms")
+		return 1.0e6;
+	else if (unit == "s")
+		return 1.0e9;
+	return 1.0;
+}
+
+void meanAndVariance(const std::vector<double> &samples, double &mean, double &variance)
+{
+	mean = 0.0;
+	for (const double sample : samples)
+		mean += sample;
+	mean /= samples.size();
+
+	variance = 0.0;
+	for (const double sample : samples)
+		variance += (sample - mean) * (sample - mean);
+	// Unbiased estimator of the population variance
+	variance = (samples.size() > 1) ? variance / (samples.size() - 1) : 0.0;
+}
+
+/// Evaluates the continued fraction of the regularized incomplete beta function with the modified Lentz's method
+double betaContinuedFraction(double a, double b, double x)
+{
+	const unsigned int MaxIterations = 200;
+	const double Epsilon = 1.0e-12;
+	const double Tiny = 1.0e-300;
+
+	double c = 1.0;
+	double d = 1.0 - (a + b) * x / (a + 1.0);
+	d = (std::fabs(d) < Tiny) ? 1.0 / Tiny : 1.0 / d;
+	double result = d;
+	for (unsigned int m = 1; m <= MaxIterations; m++)
+	{
+		// Even and odd steps of the fraction
+		for (unsigned int step = 0; step < 2; step++)
+		{
+			const double numerator = (step == 0) ? m * (b - m) * x / ((a + 2.0 * m - 1.0) * (a + 2.0 * m))
+			                                     : -(a + m) * (a + b + m) * x / ((a + 2.0 * m) * (a + 2.0 * m + 1.0));
+			d = 1.0 + numerator * d;
+			d = (std::fabs(d) < Tiny) ? 1.0 / Tiny : 1.0 / d;
+			c = 1.0 + numerator / c;
+			if (std::fabs(c) < Tiny)
+				c = Tiny;
+			result *= c * d;
+		}
+
+		if (std::fabs(c * d - 1.0) < Epsilon)
+			break;
+	}
+	return result;
+}
+
+double regularizedIncompleteBeta(double a, double b, double x)
+{
+	if (x <= 0.0)
+		return 0.0;
+	else if (x >= 1.0)
+		return 1.0;
+
+	const double front = std::exp(std::lgamma(a + b) - std::lgamma(a) - std::lgamma(b) + a * std::log(x) + b * std::log(1.0 - x));
+	// The continued fraction converges quickly only on one side of the mean of the distribution
+	if (x < (a + 1.0) / (a + b + 2.0))
+		return front * betaContinuedFraction(a, b, x) / a;
+	else
+		return 1.0 - front * betaContinuedFraction(b, a, 1.0 - x) / b;
+}
+
+/// Returns the two-tailed p-value of Welch's t-test for the difference of the means of two samples
+double welchPValue(const std::vector<double> &a, const std::vector<double> &b)
+{
+	if (a.size() < 2 || b.size() < 2)
+		return 1.0;
+
+	double meanA, varianceA, meanB, varianceB;
+	meanAndVariance(a, meanA, varianceA);
+	meanAndVariance(b, meanB, varianceB);
+
+	const double errorA = varianceA / a.size();
+	const double errorB = varianceB / b.size();
+	if (errorA + errorB <= 0.0)
+		return (meanA == meanB) ? 1.0 : 0.0;
+
+	const double t = (meanA - meanB) / std::sqrt(errorA + errorB);
+	// Welch-Satterthwaite approximation of the degrees of freedom
+	const double dof = (errorA + errorB) * (errorA + errorB) / (errorA * errorA / (a.size() - 1) + errorB * errorB / (b.size() - 1));
+	return regularizedIncompleteBeta(0.5 * dof, 0.5, dof / (dof + t * t));
+}
+
+std::string formatTime(double nanoseconds)
+{
+	const int MaxLength = 32;
+	char buffer[MaxLength];
+	if (nanoseconds >= 1.0e9)
+		snprintf(buffer, MaxLength, "%.3f s", nanoseconds / 1.0e9);
+	else if (nanoseconds >= 1.0e6)
+		snprintf(buffer, MaxLength, "%.3f ms", nanoseconds / 1.0e6);
+	else if (nanoseconds >= 1.0e3)
+		snprintf(buffer, MaxLength, "%.3f us", nanoseconds / 1.0e3);
+	else
+		snprintf(buffer, MaxLength, "%.3f ns", nanoseconds);
+	return std::string(buffer);
+}
+
+}
+
+///////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////
+
+std::string BenchResults::resultsFile(const std::string &key)
+{
+	return fs::joinPath(resultsDir(), key + extension);
+}
+
+bool BenchResults::findKey(const std::string &prefix, std::string &key)
+{
+	std::vector<std::string> files;
+	fs::listFiles(resultsDir(), files);
+
+	unsigned int numMatches = 0;
+	for (const std::string &file : files)
+	{
+		const std::string name = fs::baseName(file.data());
+		if (name.size() <= prefix.size() || name.compare(0, prefix.size(), prefix) != 0)
+			continue;
+
+		const std::string fileKey = name.substr(0, name.size() - strlen(extension));
+		// An exact match wins over the longer keys that start with it
+		if (fileKey == prefix)
+		{
+			key = fileKey;
+			return true;
+		}
+		key = fileKey;
+		numMatches++;
+	}
+
+	if (numMatches > 1)
+		Helpers::error("More than one stored run starts with: ", prefix.data());
+	return (numMatches == 1);
+}
+
+bool BenchResults::addJsonFile(const char *filename)
+{
+	JsonValue root;
+	if (JsonValue::parseFile(filename, root) == false)
+		return false;
+
+	const JsonValue *benchmarks = root.member("benchmarks");
+	if (benchmarks == nullptr || benchmarks->isArray() == false)
+		return false;
+
+	for (const JsonValue &benchmark : benchmarks->elements())
+	{
+		// Means, medians and standard deviations of the repetitions are computed here
+		if (benchmark.stringMember("run_type") == "aggregate")
+			continue;
+
+		const std::string &runName = benchmark.stringMember("run_name");
+		const std::string &name = runName.empty() ? benchmark.stringMember("name") : runName;
+		const double realTime = benchmark.numberMember("real_time", -1.0);
+		if (name.empty() || realTime < 0.0)
+			continue;
+
+		samples_[name].push_back(realTime * unitToNanoseconds(benchmark.stringMember("time_unit")));
+	}
+
+	return true;
+}
+
+bool BenchResults::load(const std::string &key)
+{
+	std::ifstream file(resultsFile(key));
+	if (file.is_open() == false)
+		return false;
+
+	samples_.clear();
+	std::string line;
+	while (std::getline(file, line))
+	{
+		if (line.empty() == false && line.back() == '\r')
+			line.pop_back();
+		const size_t tab = line.find('\t');
+		if (line.empty() || line[0] == '#' || tab == std::string::npos)
+			continue;
+
+		std::vector<double> &samples = samples_[line.substr(0, tab)];
+		std::istringstream stream(line.substr(tab + 1));
+		std::string sample;
+		while (std::getline(stream, sample, ','))
+			samples.push_back(strtod(sample.data(), nullptr));
+	}
+
+	return true;
+}
+
+bool BenchResults::save(const std::string &key) const
+{
+	std::ofstream file(resultsFile(key), std::ios::trunc);
+	if (file.is_open() == false)
+		return false;
+
+	file << header << "\n";
+	file.precision(12);
+	for (const auto &pair : samples_)
+	{
+		file << pair.first << '\t';
+		for (unsigned int i = 0; i < pair.second.size(); i++)
+			file << (i > 0 ? "," : "") << pair.second[i];
+		file << "\n";
+	}
+
+	return file.good();
+}
+
+unsigned int BenchResults::compare(const BenchResults &baseline, const BenchResults &current, float significance)
+{
+	const int MaxLength = 512;
+	char buffer[MaxLength];
+	unsigned int numCompared = 0;
+	unsigned int numRegressions = 0;
+	unsigned int numImprovements = 0;
+
+	for (const auto &pair : current.samples_)
+	{
+		auto baselineIt = baseline.samples_.find(pair.first);
+		if (baselineIt == baseline.samples_.end())
+			continue;
+		numCompared++;
+
+		double baselineMean, baselineVariance, currentMean, currentVariance;
+		meanAndVariance(baselineIt->second, baselineMean, baselineVariance);
+		meanAndVariance(pair.second, currentMean, currentVariance);
+		const double change = (baselineMean > 0.0) ? 100.0 * (currentMean - baselineMean) / baselineMean : 0.0;
+		const double pValue = welchPValue(baselineIt->second, pair.second);
+
+		const char *verdict = "";
+		if (pValue < significance && std::fabs(change) >= MinRelativeChange)
+		{
+			verdict = (change > 0.0) ? "  SLOWER" : "  faster";
+			(change > 0.0) ? numRegressions++ : numImprovements++;
+		}
+
+		snprintf(buffer, MaxLength, "%14s %14s %+8.2f%%  p=%.4f%s  %s", formatTime(baselineMean).data(), formatTime(currentMean).data(),
+		         change, pValue, verdict, pair.first.data());
+		std::cout << buffer << "\n";
+	}
+	std::cout << std::flush;
+
+	snprintf(buffer, MaxLength, "%u benchmarks compared, %u significantly slower, %u significantly faster (p < %.2f)",
+	         numCompared, numRegressions, numImprovements, significance);
+	Helpers::info("Benchmark comparison: ", buffer);
+	if (numCompared < current.numBenchmarks() || numCompared < baseline.numBenchmarks())
+		Helpers::info("Benchmarks that are only present in one of the runs are not compared");
+
+	return numRegressions;
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+
+/// The repeated measurements of every benchmark of a run, stored by commit and settings
+class BenchResults
+{
+  public:
+	/// Returns the directory that contains a results file for every stored run
+	static const char *resultsDir() { return "ncline-bench"; }
+	static std::string resultsFile(const std::string &key);
+	/// Finds the key of a stored run from its beginning, like an abbreviated commit
+	static bool findKey(const std::string &prefix, std::string &key);
+
+	/// Adds the iterations of a Google Benchmark JSON output file
+	bool addJsonFile(const char *filename);
+	bool load(const std::string &key);
+	bool save(const std::string &key) const;
+
+	inline unsigned int numBenchmarks() const { return static_cast<unsigned int>(samples_.size()); }
+
+	/// Compares two runs with Welch's t-test, returns the number of significant regressions
+	static unsigned int compare(const BenchResults &baseline, const BenchResults &current, float significance);
+
+  private:
+	/// The real times of every repetition of a benchmark, in nanoseconds
+	std::map<std::string, std::vector<double>> samples_;
+};
@@ -0,0 +1,245 @@
+#include <cassert>
+#include <cstdio>
+#include <cstdint>
+#include <fstream>
+#include "BinaryCache.h"
+#include "GitCommand.h"
+#include "CMakeCommand.h"
+#include "Process.h"
+#include "FileSystem.h"
+#include "Settings.h"
+#include "Configuration.h"
+#include "Helpers.h"
+
+#ifdef _WIN32
+	#include <process.h>
+#else
+	#include <unistd.h>
+#endif
+
+namespace {
+
+/// The directories of an installed engine that can contain its CMake package
+const char *packageDirs[] = { "lib/cmake/nCine", "lib64/cmake/nCine", "share/nCine/cmake", "cmake" };
+/// The file that records the key of the entry copied next to a build directory
+const char *keyFile = "ncline-cache-key";
+
+uint64_t fnv1a(const std::string &string)
+{
+	uint64_t hash = 14695981039346656037ULL;
+	for (const char c : string)
+	{
+		hash ^= static_cast<unsigned char>(c);
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+void replaceAll(std::string &string, const std::string &from, const std::string &to)
+{
+	if (from.empty())
+		return;
+
+	size_t position = string.find(from);
+	while (position != std::string::npos)
+	{
+		string.replace(position, from.size(), to);
+		position = string.find(from, position + to.size());
+	}
+}
+
+/// Retrieves the compiler path chosen at configuration time from the CMake cache
+bool cachedCompiler(const std::string &buildDir, std::string &compiler)
+{
+	std::ifstream file(fs::joinPath(buildDir, "CMakeCache.txt"));
+	if (file.is_open() == false)
+		return false;
+
+	const std::string prefix = "CMAKE_CXX_COMPILER:";
+	std::string line;
+	while (std::getline(file, line))
+	{
+		if (line.compare(0, prefix.size(), prefix) == 0)
+		{
+			const size_t equal = line.find('=');
+			if (equal != std::string::npos)
+				compiler = line.substr(equal + 1);
+			return (compiler.empty() == false);
+		}
+	}
+
+	return false;
+}
+
+bool addRepositoryHead(GitCommand &git, const char *repositoryDir, std::string &keyString)
+{
+	const std::string repositoryGitDir = fs::joinPath(repositoryDir, ".git");
+	if (fs::exists(repositoryGitDir.data()) == false)
+		return false;
+
+	std::string hash;
+	if (git.retrieveHead(repositoryDir, hash) == false)
+		return false;
+
+	keyString += std::string(repositoryDir) + "=" + hash + "\n";
+	return true;
+}
+
+bool readKey(const std::string &localDir, std::string &key)
+{
+	std::ifstream file(fs::joinPath(localDir, keyFile));
+	return (file.is_open() && std::getline(file, key));
+}
+
+}
+
+///////////////////////////////////////////////////////////
+// CONSTRUCTORS and DESTRUCTOR
+///////////////////////////////////////////////////////////
+
+BinaryCache::BinaryCache(GitCommand &git, CMakeCommand &cmake)
+    : git_(git), cmake_(cmake), enabled_(false)
+{
+	enabled_ = config().binaryCacheDir(cacheDir_) && cacheDir_.empty() == false && cmake_.supportsInstall();
+}
+
+///////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////
+
+bool BinaryCache::computeKey(const std::string &buildDir, const std::string &arguments, const Settings &settings)
+{
+	key_.clear();
+	if (enabled_ == false)
+		return false;
+
+	// A build of modified sources is not described by its commit
+	if (git_.hasLocalChanges(Helpers::nCineSourceDir()))
+	{
+		Helpers::info("The engine repository has local changes, the binary cache is not used");
+		return false;
+	}
+
+	std::string keyString;
+	if (addRepositoryHead(git_, Helpers::nCineSourceDir(), keyString) == false)
+		return false;
+	addRepositoryHead(git_, Helpers::nCineLibrariesSourceDir(), keyString);
+	addRepositoryHead(git_, Helpers::nCineAndroidLibrariesSourceDir(), keyString);
+	addRepositoryHead(git_, Helpers::nCineLibrariesArtifactsSourceDir(), keyString);
+
+	std::string compiler;
+	if (cachedCompiler(buildDir, compiler) == false)
+		return false;
+	keyString += "compiler=" + compiler + "\n";
+	std::string compilerVersion;
+	const std::string versionCommand = "\"" + compiler + "\" --version " + Helpers::redirectErrorsToNull();
+	if (Process::executeCommand(versionCommand.data(), compilerVersion, Process::Echo::DISABLED, Process::OverrideDryRun::ENABLED))
+		keyString += compilerVersion.substr(0, compilerVersion.find('\n')) + "\n";
+
+	keyString += std::string("build_type=") + Settings::buildTypeToString(settings.buildType()) + "\n";
+	keyString += "platform=" + std::to_string(static_cast<int>(config().platform())) + "\n";
+
+	// Absolute paths inside the workspace, like the one of the libraries, should not prevent sharing
+	std::string workspaceArguments = arguments;
+	replaceAll(workspaceArguments, fs::currentDir(), "<workspace>");
+	keyString += "arguments=" + workspaceArguments + "\n";
+
+	const int MaxLength = 32;
+	char buffer[MaxLength];
+	snprintf(buffer, MaxLength, "%016llx", static_cast<unsigned long long>(fnv1a(keyString)));
+	key_ = buffer;
+
+	return true;
+}
+
+bool BinaryCache::restore(const std::string &buildDir, std::string &engineDir)
+{
+	if (key_.empty())
+		return false;
+
+	const std::string entry = entryDir();
+	if (fs::exists(entry.data()) == false)
+	{
+		Helpers::info("Binary cache miss for the key: ", key_.data());
+		return false;
+	}
+	Helpers::info("Binary cache hit for the key: ", key_.data());
+
+	const std::string localDir = buildDir + "-cached";
+	std::string localKey;
+	if (readKey(localDir, localKey) && localKey == key_)
+		Helpers::info("The cached engine is already in: ", localDir.data());
+	else
+	{
+		if (fs::exists(localDir.data()))
+		{
+			const std::string removeCommand = cmake_.removeDir() + ("\"" + localDir + "\"");
+			cmake_.toolsMode(removeCommand.data());
+		}
+
+		const std::string copyCommand = "copy_directory \"" + entry + "\" \"" + localDir + "\"";
+		if (cmake_.toolsMode(copyCommand.data()) == false)
+			return false;
+
+		std::ofstream file(fs::joinPath(localDir, keyFile), std::ios::trunc);
+		file << key_ << "\n";
+	}
+
+	for (const char *packageDir : packageDirs)
+	{
+		const std::string directory = fs::joinPath(localDir, packageDir);
+		if (fs::exists(fs::joinPath(directory, "nCineConfig.cmake").data()))
+		{
+			engineDir = directory;
+			return true;
+		}
+	}
+
+	Helpers::error("Cannot find the CMake package of the cached engine in: ", localDir.data());
+	return false;
+}
+
+bool BinaryCache::store(const std::string &buildDir, const char *config)
+{
+	if (key_.empty())
+		return false;
+
+	const std::string entry = entryDir();
+	if (fs::exists(entry.data()))
+		return true;
+
+	// Installing in a temporary directory and renaming it keeps concurrent builds from reading a partial entry
+	const int MaxLength = 64;
+	char suffix[MaxLength];
+#ifdef _WIN32
+	snprintf(suffix, MaxLength, ".tmp-%d", _getpid());
+#else
+	snprintf(suffix, MaxLength, ".tmp-%d", static_cast<int>(getpid()));
+#endif
+	const std::string temporaryDir = entry + suffix;
+
+	Helpers::info("Store the engine in the binary cache: ", entry.data());
+	bool stored = cmake_.install(buildDir.data(), config, temporaryDir.data());
+	if (stored)
+	{
+		const std::string renameCommand = "rename \"" + temporaryDir + "\" \"" + entry + "\"";
+		stored = cmake_.toolsMode(renameCommand.data());
+	}
+
+	if (stored == false && fs::exists(temporaryDir.data()))
+	{
+		const std::string removeCommand = cmake_.removeDir() + ("\"" + temporaryDir + "\"");
+		cmake_.toolsMode(removeCommand.data());
+	}
+
+	return stored;
+}
+
+///////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+///////////////////////////////////////////////////////////
+
+std::string BinaryCache::entryDir() const
+{
+	return fs::joinPath(cacheDir_, key_);
+}
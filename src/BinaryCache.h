@@ -0,0 +1,33 @@
+#pragma once
+
+#include <string>
+
+class Settings;
+class GitCommand;
+class CMakeCommand;
+
+/// A local or shared directory of installed engine builds, indexed by a key of their inputs
+class BinaryCache
+{
+  public:
+	BinaryCache(GitCommand &git, CMakeCommand &cmake);
+
+	inline bool enabled() const { return enabled_; }
+	inline const std::string &key() const { return key_; }
+
+	/// Computes the key of the engine build, returns false if the build cannot be cached
+	bool computeKey(const std::string &buildDir, const std::string &arguments, const Settings &settings);
+	/// Copies the cached engine next to the build directory, unless it is already there, and returns the directory of its CMake package
+	bool restore(const std::string &buildDir, std::string &engineDir);
+	/// Installs the engine of a build directory in the cache
+	bool store(const std::string &buildDir, const char *config);
+
+  private:
+	GitCommand &git_;
+	CMakeCommand &cmake_;
+	bool enabled_;
+	std::string cacheDir_;
+	std::string key_;
+
+	std::string entryDir() const;
+};
@@ -0,0 +1,829 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <vector>
+#include "BinarySize.h"
+#include "FileSystem.h"
+#include "Helpers.h"
+
+#ifdef __GNUC__
+	#include <cxxabi.h>
+#endif
+
+namespace {
+
+const char *header = "# ncline binary sizes v1";
+const char *kindNames[] = { "file", "section", "symbol", "unit" };
+const char *unitsUnavailable = "No compilation unit sizes, the binaries have neither uncompressed debug information nor a static symbol table";
+
+const unsigned int ElfTypeExecutable = 2;
+const unsigned int ElfTypeShared = 3;
+const unsigned int SectionTypeSymbols = 2;
+const unsigned int SectionTypeNoBits = 8;
+const unsigned int SectionTypeDynamicSymbols = 11;
+const uint64_t SectionFlagCompressed = 0x800;
+const unsigned int SymbolTypeObject = 1;
+const unsigned int SymbolTypeFunction = 2;
+const unsigned int SymbolTypeFile = 4;
+const unsigned int SymbolTypeTls = 6;
+const unsigned int SymbolBindingLocal = 0;
+const unsigned int SymbolTypeIndirectFunction = 10;
+const unsigned int SectionIndexUndefined = 0;
+const unsigned int SectionIndexReserved = 0xff00;
+
+/// A bounds checked reader of little-endian data, it stops and returns zeros after an out of range access
+class Reader
+{
+  public:
+	Reader(const unsigned char *data, size_t size)
+	    : data_(data), size_(size), pos_(0), valid_(true) {}
+
+	inline bool valid() const { return valid_; }
+	inline bool atEnd() const { return pos_ >= size_; }
+	inline size_t pos() const { return pos_; }
+	inline void seek(size_t pos) { valid_ = valid_ && pos <= size_; pos_ = valid_ ? pos : size_; }
+	inline void skip(uint64_t bytes) { seek((bytes <= size_ - pos_) ? pos_ + static_cast<size_t>(bytes) : size_ + 1); }
+
+	uint64_t unsignedValue(unsigned int bytes)
+	{
+		if (valid_ == false || bytes > size_ - pos_)
+		{
+			valid_ = false;
+			pos_ = size_;
+			return 0;
+		}
+
+		uint64_t value = 0;
+		for (unsigned int i = 0; i < bytes; i++)
+			value |= static_cast<uint64_t>(data_[pos_ + i]) << (8 * i);
+		pos_ += bytes;
+		return value;
+	}
+
+	uint64_t uleb128()
+	{
+		uint64_t value = 0;
+		unsigned int shift = 0;
+		while (valid_ && pos_ < size_)
+		{
+			const unsigned char byte = data_[pos_++];
+			if (shift < 64)
+				value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+			shift += 7;
+			if ((byte & 0x80) == 0)
+				return value;
+		}
+		valid_ = false;
+		return 0;
+	}
+
+	int64_t sleb128()
+	{
+		int64_t value = 0;
+		unsigned int shift = 0;
+		while (valid_ && pos_ < size_)
+		{
+			const unsigned char byte = data_[pos_++];
+			if (shift < 64)
+				value |= static_cast<int64_t>(byte & 0x7f) << shift;
+			shift += 7;
+			if ((byte & 0x80) == 0)
+			{
+				if (shift < 64 && (byte & 0x40))
+					value |= -(static_cast<int64_t>(1) << shift);
+				return value;
+			}
+		}
+		valid_ = false;
+		return 0;
+	}
+
+	std::string cString()
+	{
+		const size_t start = pos_;
+		while (pos_ < size_ && data_[pos_] != '\0')
+			pos_++;
+		if (pos_ >= size_)
+		{
+			valid_ = false;
+			return std::string();
+		}
+		return std::string(reinterpret_cast<const char *>(data_ + start), pos_++ - start);
+	}
+
+  private:
+	const unsigned char *data_;
+	size_t size_;
+	size_t pos_;
+	bool valid_;
+};
+
+struct Section
+{
+	std::string name;
+	unsigned int type = 0;
+	uint64_t flags = 0;
+	uint64_t offset = 0;
+	uint64_t size = 0;
+	unsigned int link = 0;
+};
+
+std::string stringAt(const std::vector<unsigned char> &data, const Section *section, uint64_t offset)
+{
+	if (section == nullptr || offset >= section->size || section->offset + section->size > data.size())
+		return std::string();
+
+	Reader reader(data.data() + section->offset, static_cast<size_t>(section->size));
+	reader.seek(static_cast<size_t>(offset));
+	return reader.cString();
+}
+
+const Section *findSection(const std::vector<Section> &sections, const char *name)
+{
+	for (const Section &section : sections)
+	{
+		// Compressed debug sections would need zlib or zstd to be read
+		if (section.name == name && section.type != SectionTypeNoBits && (section.flags & SectionFlagCompressed) == 0)
+			return &section;
+	}
+	return nullptr;
+}
+
+Reader sectionReader(const std::vector<unsigned char> &data, const Section *section)
+{
+	if (section == nullptr || section->offset + section->size > data.size())
+		return Reader(nullptr, 0);
+	return Reader(data.data() + section->offset, static_cast<size_t>(section->size));
+}
+
+std::string demangle(const std::string &name)
+{
+#ifdef __GNUC__
+	int status = 0;
+	char *demangled = abi::__cxa_demangle(name.data(), nullptr, nullptr, &status);
+	if (status == 0 && demangled != nullptr)
+	{
+		const std::string result(demangled);
+		free(demangled);
+		return result;
+	}
+#endif
+	return name;
+}
+
+bool readSections(const std::vector<unsigned char> &data, bool is64Bit, std::vector<Section> &sections)
+{
+	Reader reader(data.data(), data.size());
+	reader.seek(is64Bit ? 0x28 : 0x20);
+	const uint64_t sectionsOffset = reader.unsignedValue(is64Bit ? 8 : 4);
+	reader.seek(is64Bit ? 0x3a : 0x2e);
+	const unsigned int sectionSize = static_cast<unsigned int>(reader.unsignedValue(2));
+	const unsigned int numSections = static_cast<unsigned int>(reader.unsignedValue(2));
+	const unsigned int namesIndex = static_cast<unsigned int>(reader.unsignedValue(2));
+	if (reader.valid() == false || sectionsOffset == 0 || sectionSize < (is64Bit ? 64u : 40u))
+		return false;
+
+	std::vector<unsigned int> nameOffsets;
+	for (unsigned int i = 0; i < numSections; i++)
+	{
+		Section section;
+		reader.seek(static_cast<size_t>(sectionsOffset + i * sectionSize));
+		nameOffsets.push_back(static_cast<unsigned int>(reader.unsignedValue(4)));
+		section.type = static_cast<unsigned int>(reader.unsignedValue(4));
+		section.flags = reader.unsignedValue(is64Bit ? 8 : 4);
+		reader.unsignedValue(is64Bit ? 8 : 4); // address
+		section.offset = reader.unsignedValue(is64Bit ? 8 : 4);
+		section.size = reader.unsignedValue(is64Bit ? 8 : 4);
+		section.link = static_cast<unsigned int>(reader.unsignedValue(4));
+		if (reader.valid() == false)
+			return false;
+		sections.push_back(section);
+	}
+
+	const Section *names = (namesIndex < sections.size()) ? &sections[namesIndex] : nullptr;
+	for (unsigned int i = 0; i < sections.size(); i++)
+		sections[i].name = stringAt(data, names, nameOffsets[i]);
+
+	return true;
+}
+
+/// Reads the sized functions and variables of the static symbol table, or of the dynamic one for stripped binaries
+/// \param fileSymbols The size of the local symbols of the static table by the source file that precedes them, which defines them
+void readSymbols(const std::vector<unsigned char> &data, bool is64Bit, const std::vector<Section> &sections, std::map<std::string, uint64_t> &symbols,
+                 std::map<std::string, uint64_t> &fileSymbols)
+{
+	const Section *table = nullptr;
+	for (const Section &section : sections)
+	{
+		if (section.type == SectionTypeSymbols)
+			table = &section;
+		else if (section.type == SectionTypeDynamicSymbols && table == nullptr)
+			table = &section;
+	}
+	if (table == nullptr || table->link >= sections.size())
+		return;
+
+	const Section *names = &sections[table->link];
+	const unsigned int symbolSize = is64Bit ? 24 : 16;
+	Reader reader = sectionReader(data, table);
+	// Aliases like the complete and base object constructors share their code
+	std::map<std::pair<uint64_t, uint64_t>, bool> seenAddresses;
+	std::string sourceFile;
+	while (reader.valid() && reader.pos() + symbolSize <= static_cast<size_t>(table->size))
+	{
+		uint64_t nameOffset, value, size;
+		unsigned int info, sectionIndex;
+		nameOffset = reader.unsignedValue(4);
+		if (is64Bit)
+		{
+			info = static_cast<unsigned int>(reader.unsignedValue(1));
+			reader.unsignedValue(1); // other
+			sectionIndex = static_cast<unsigned int>(reader.unsignedValue(2));
+			value = reader.unsignedValue(8);
+			size = reader.unsignedValue(8);
+		}
+		else
+		{
+			value = reader.unsignedValue(4);
+			size = reader.unsignedValue(4);
+			info = static_cast<unsigned int>(reader.unsignedValue(1));
+			reader.unsignedValue(1); // other
+			sectionIndex = static_cast<unsigned int>(reader.unsignedValue(2));
+		}
+
+		const unsigned int type = info & 0xf;
+		const unsigned int binding = info >> 4;
+		// The local symbols of every object file follow a symbol with the name of its source, the global ones come after all of them
+		if (type == SymbolTypeFile && table->type == SectionTypeSymbols)
+		{
+			sourceFile = stringAt(data, names, nameOffset);
+			continue;
+		}
+		else if (binding != SymbolBindingLocal)
+			sourceFile.clear();
+
+		if (size == 0 || sectionIndex == SectionIndexUndefined || sectionIndex >= SectionIndexReserved ||
+		    (type != SymbolTypeObject && type != SymbolTypeFunction && type != SymbolTypeTls && type != SymbolTypeIndirectFunction))
+			continue;
+
+		bool &seen = seenAddresses[std::make_pair(value, size)];
+		if (seen)
+			continue;
+		seen = true;
+
+		const std::string name = stringAt(data, names, nameOffset);
+		if (name.empty() == false)
+			symbols[demangle(name)] += size;
+		if (sourceFile.empty() == false)
+			fileSymbols[sourceFile] += size;
+	}
+}
+
+struct Abbreviation
+{
+	unsigned int form = 0;
+	unsigned int attribute = 0;
+	int64_t implicitConst = 0;
+};
+
+const unsigned int AttributeName = 0x03;
+const unsigned int AttributeLowPc = 0x11;
+const unsigned int AttributeHighPc = 0x12;
+const unsigned int AttributeStrOffsetsBase = 0x72;
+
+const unsigned int FormAddr = 0x01;
+const unsigned int FormString = 0x08;
+const unsigned int FormStrp = 0x0e;
+const unsigned int FormIndirect = 0x16;
+const unsigned int FormImplicitConst = 0x21;
+const unsigned int FormLineStrp = 0x1f;
+const unsigned int FormStrx = 0x1a;
+const unsigned int FormStrx1 = 0x25;
+const unsigned int FormStrx4 = 0x28;
+
+/// Reads an attribute value as a number, or skips it if it is not a constant, an address, an offset or an index
+bool readForm(Reader &reader, unsigned int form, unsigned int version, unsigned int addressSize, uint64_t &value)
+{
+	value = 0;
+	switch (form)
+	{
+		case 0x01: value = reader.unsignedValue(addressSize); break; // addr
+		case 0x03: reader.skip(reader.unsignedValue(2)); break; // block2
+		case 0x04: reader.skip(reader.unsignedValue(4)); break; // block4
+		case 0x05: value = reader.unsignedValue(2); break; // data2
+		case 0x06: value = reader.unsignedValue(4); break; // data4
+		case 0x07: value = reader.unsignedValue(8); break; // data8
+		case 0x08: reader.cString(); break; // string
+		case 0x09: reader.skip(reader.uleb128()); break; // block
+		case 0x0a: reader.skip(reader.unsignedValue(1)); break; // block1
+		case 0x0b: value = reader.unsignedValue(1); break; // data1
+		case 0x0c: value = reader.unsignedValue(1); break; // flag
+		case 0x0d: value = static_cast<uint64_t>(reader.sleb128()); break; // sdata
+		case 0x0e: value = reader.unsignedValue(4); break; // strp
+		case 0x0f: value = reader.uleb128(); break; // udata
+		case 0x10: value = reader.unsignedValue(version <= 2 ? addressSize : 4); break; // ref_addr
+		case 0x11: value = reader.unsignedValue(1); break; // ref1
+		case 0x12: value = reader.unsignedValue(2); break; // ref2
+		case 0x13: value = reader.unsignedValue(4); break; // ref4
+		case 0x14: value = reader.unsignedValue(8); break; // ref8
+		case 0x15: value = reader.uleb128(); break; // ref_udata
+		case 0x17: value = reader.unsignedValue(4); break; // sec_offset
+		case 0x18: reader.skip(reader.uleb128()); break; // exprloc
+		case 0x19: value = 1; break; // flag_present
+		case 0x1a: value = reader.uleb128(); break; // strx
+		case 0x1b: value = reader.uleb128(); break; // addrx
+		case 0x1c: value = reader.unsignedValue(4); break; // ref_sup4
+		case 0x1d: value = reader.unsignedValue(4); break; // strp_sup
+		case 0x1e: reader.skip(16); break; // data16
+		case 0x1f: value = reader.unsignedValue(4); break; // line_strp
+		case 0x20: value = reader.unsignedValue(8); break; // ref_sig8
+		case 0x21: break; // implicit_const, the value is in the abbreviation
+		case 0x22: value = reader.uleb128(); break; // loclistx
+		case 0x23: value = reader.uleb128(); break; // rnglistx
+		case 0x24: value = reader.unsignedValue(8); break; // ref_sup8
+		case 0x25: value = reader.unsignedValue(1); break; // strx1
+		case 0x26: value = reader.unsignedValue(2); break; // strx2
+		case 0x27: value = reader.unsignedValue(3); break; // strx3
+		case 0x28: value = reader.unsignedValue(4); break; // strx4
+		case 0x29: value = reader.unsignedValue(1); break; // addrx1
+		case 0x2a: value = reader.unsignedValue(2); break; // addrx2
+		case 0x2b: value = reader.unsignedValue(3); break; // addrx3
+		case 0x2c: value = reader.unsignedValue(4); break; // addrx4
+		case 0x1f01: value = reader.uleb128(); break; // GNU_addr_index
+		case 0x1f02: value = reader.uleb128(); break; // GNU_str_index
+		case 0x1f20: value = reader.unsignedValue(4); break; // GNU_ref_alt
+		case 0x1f21: value = reader.unsignedValue(4); break; // GNU_strp_alt
+		default: return false;
+	}
+	return reader.valid();
+}
+
+/// Reads the attributes of the abbreviation with the specified code, in the table that starts at an offset
+bool readAbbreviation(Reader reader, uint64_t tableOffset, uint64_t code, std::vector<Abbreviation> &attributes)
+{
+	reader.seek(static_cast<size_t>(tableOffset));
+	while (reader.valid() && reader.atEnd() == false)
+	{
+		const uint64_t entryCode = reader.uleb128();
+		if (entryCode == 0)
+			return false;
+		reader.uleb128(); // tag
+		reader.unsignedValue(1); // children
+
+		attributes.clear();
+		while (reader.valid())
+		{
+			Abbreviation abbreviation;
+			abbreviation.attribute = static_cast<unsigned int>(reader.uleb128());
+			abbreviation.form = static_cast<unsigned int>(reader.uleb128());
+			if (abbreviation.attribute == 0 && abbreviation.form == 0)
+				break;
+			if (abbreviation.form == FormImplicitConst)
+				abbreviation.implicitConst = reader.sleb128();
+			attributes.push_back(abbreviation);
+		}
+
+		if (entryCode == code)
+			return reader.valid();
+	}
+	return false;
+}
+
+/// Sums the lengths of the address ranges of every compilation unit, by the offset of the unit
+void readAddressRanges(const std::vector<unsigned char> &data, const std::vector<Section> &sections, std::map<uint64_t, uint64_t> &unitSizes)
+{
+	Reader reader = sectionReader(data, findSection(sections, ".debug_aranges"));
+	while (reader.valid() && reader.atEnd() == false)
+	{
+		const size_t start = reader.pos();
+		const uint64_t length = reader.unsignedValue(4);
+		// 64-bit DWARF is not supported
+		if (length == 0 || length >= 0xfffffff0)
+			return;
+		const size_t end = start + 4 + static_cast<size_t>(length);
+
+		reader.unsignedValue(2); // version
+		const uint64_t unitOffset = reader.unsignedValue(4);
+		const unsigned int addressSize = static_cast<unsigned int>(reader.unsignedValue(1));
+		reader.unsignedValue(1); // segment selector size
+		if (addressSize != 4 && addressSize != 8)
+			return;
+
+		// The tuples are aligned to twice the address size from the start of the set
+		const size_t tupleSize = 2 * addressSize;
+		reader.seek(start + ((reader.pos() - start + tupleSize - 1) / tupleSize) * tupleSize);
+		while (reader.valid() && reader.pos() + tupleSize <= end)
+		{
+			const uint64_t address = reader.unsignedValue(addressSize);
+			const uint64_t rangeLength = reader.unsignedValue(addressSize);
+			if (address == 0 && rangeLength == 0)
+				break;
+			unitSizes[unitOffset] += rangeLength;
+		}
+		reader.seek(end);
+	}
+}
+
+/// Reads the name and the size of every compilation unit, using the address ranges or the bounds of its code
+void readUnits(const std::vector<unsigned char> &data, const std::vector<Section> &sections, std::map<std::string, uint64_t> &units)
+{
+	const Section *info = findSection(sections, ".debug_info");
+	const Section *abbrev = findSection(sections, ".debug_abbrev");
+	if (info == nullptr || abbrev == nullptr)
+		return;
+
+	std::map<uint64_t, uint64_t> unitSizes;
+	readAddressRanges(data, sections, unitSizes);
+
+	const Section *strings = findSection(sections, ".debug_str");
+	const Section *lineStrings = findSection(sections, ".debug_line_str");
+	const Section *stringOffsets = findSection(sections, ".debug_str_offsets");
+	const Reader abbrevReader = sectionReader(data, abbrev);
+	Reader reader = sectionReader(data, info);
+	std::vector<Abbreviation> attributes;
+
+	while (reader.valid() && reader.atEnd() == false)
+	{
+		const size_t start = reader.pos();
+		const uint64_t length = reader.unsignedValue(4);
+		if (length == 0 || length >= 0xfffffff0)
+			return;
+		const size_t end = start + 4 + static_cast<size_t>(length);
+
+		const unsigned int version = static_cast<unsigned int>(reader.unsignedValue(2));
+		unsigned int unitType = 1;
+		uint64_t abbrevOffset = 0;
+		unsigned int addressSize = 0;
+		if (version >= 5)
+		{
+			unitType = static_cast<unsigned int>(reader.unsignedValue(1));
+			addressSize = static_cast<unsigned int>(reader.unsignedValue(1));
+			abbrevOffset = reader.unsignedValue(4);
+			// Skeleton and split units have an identifier of the split object
+			if (unitType == 4 || unitType == 5)
+				reader.unsignedValue(8);
+		}
+		else
+		{
+			abbrevOffset = reader.unsignedValue(4);
+			addressSize = static_cast<unsigned int>(reader.unsignedValue(1));
+		}
+
+		// Type units do not have code
+		const uint64_t code = reader.uleb128();
+		if (reader.valid() == false || (unitType != 1 && unitType != 3 && unitType != 4) || code == 0 ||
+		    readAbbreviation(abbrevReader, abbrevOffset, code, attributes) == false)
+		{
+			reader.seek(end);
+			continue;
+		}
+
+		std::string name;
+		unsigned int nameForm = 0;
+		uint64_t nameValue = 0;
+		uint64_t lowPc = 0;
+		uint64_t highPc = 0;
+		bool highPcIsAddress = false;
+		uint64_t stringOffsetsBase = 8;
+		for (const Abbreviation &attribute : attributes)
+		{
+			unsigned int form = attribute.form;
+			if (form == FormIndirect)
+				form = static_cast<unsigned int>(reader.uleb128());
+
+			uint64_t value = 0;
+			if (attribute.attribute == AttributeName && form == FormString)
+				name = reader.cString();
+			else if (readForm(reader, form, version, addressSize, value) == false)
+				break;
+			if (form == FormImplicitConst)
+				value = static_cast<uint64_t>(attribute.implicitConst);
+
+			switch (attribute.attribute)
+			{
+				case AttributeName:
+					nameForm = form;
+					nameValue = value;
+					break;
+				case AttributeLowPc: lowPc = value; break;
+				case AttributeHighPc:
+					highPc = value;
+					highPcIsAddress = (form == FormAddr);
+					break;
+				case AttributeStrOffsetsBase: stringOffsetsBase = value; break;
+				default: break;
+			}
+		}
+
+		// The string offsets base can follow the name
+		if (nameForm == FormStrp)
+			name = stringAt(data, strings, nameValue);
+		else if (nameForm == FormLineStrp)
+			name = stringAt(data, lineStrings, nameValue);
+		else if (nameForm == FormStrx || (nameForm >= FormStrx1 && nameForm <= FormStrx4))
+		{
+			Reader offsetsReader = sectionReader(data, stringOffsets);
+			offsetsReader.seek(static_cast<size_t>(stringOffsetsBase + nameValue * 4));
+			name = stringAt(data, strings, offsetsReader.unsignedValue(4));
+		}
+
+		auto sizeIt = unitSizes.find(start);
+		uint64_t size = (sizeIt != unitSizes.end()) ? sizeIt->second : 0;
+		if (size == 0 && highPc > 0)
+			size = highPcIsAddress ? (highPc > lowPc ? highPc - lowPc : 0) : highPc;
+		if (name.empty() == false && size > 0)
+			units[name] += size;
+
+		reader.seek(end);
+	}
+}
+
+std::string formatSize(unsigned long long bytes)
+{
+	const int MaxLength = 32;
+	char buffer[MaxLength];
+	if (bytes >= 1024 * 1024)
+		snprintf(buffer, MaxLength, "%.2f MiB", bytes / (1024.0 * 1024.0));
+	else if (bytes >= 1024)
+		snprintf(buffer, MaxLength, "%.1f KiB", bytes / 1024.0);
+	else
+		snprintf(buffer, MaxLength, "%llu B", bytes);
+	return std::string(buffer);
+}
+
+std::string formatDelta(long long bytes)
+{
+	const std::string size = formatSize(static_cast<unsigned long long>(bytes < 0 ? -bytes : bytes));
+	return (bytes < 0 ? "-" : "+") + size;
+}
+
+/// Returns the entry name, followed by the binary name when there is more than one binary
+std::string displayName(const std::string &key, bool withBinary)
+{
+	const size_t tab = key.find('\t');
+	if (tab == std::string::npos)
+		return key;
+	return withBinary ? key.substr(tab + 1) + "  [" + key.substr(0, tab) + "]" : key.substr(tab + 1);
+}
+
+bool isSkippedDirectory(const std::string &path)
+{
+	// Object files and the copies made by CPack are not the produced binaries
+	return (path.find("CMakeFiles") != std::string::npos || path.find("_CPack_Packages") != std::string::npos);
+}
+
+}
+
+///////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////
+
+std::string BinarySize::snapshotFile(const std::string &distDir)
+{
+	return fs::joinPath(snapshotsDir(), fs::baseName(distDir.data()) + ".tsv");
+}
+
+unsigned int BinarySize::addDirectory(const std::string &directory)
+{
+	std::vector<std::string> files;
+	fs::listFiles(directory.data(), files);
+	std::sort(files.begin(), files.end());
+
+	unsigned int numAdded = 0;
+	for (const std::string &file : files)
+	{
+		if (isSkippedDirectory(file))
+			continue;
+
+		std::string name = file;
+		if (name.compare(0, directory.size(), directory) == 0 && name.size() > directory.size() + 1)
+			name = name.substr(directory.size() + 1);
+		if (addElfFile(file, name))
+			numAdded++;
+	}
+
+	return numAdded;
+}
+
+bool BinarySize::addElfFile(const std::string &filename, const std::string &name)
+{
+	std::ifstream file(filename, std::ios::binary);
+	if (file.is_open() == false)
+		return false;
+
+	char magic[4] = {};
+	if (file.read(magic, 4).good() == false || memcmp(magic, "\177ELF", 4) != 0)
+		return false;
+	file.seekg(0, std::ios::end);
+	const std::streamoff fileSize = file.tellg();
+	file.seekg(0, std::ios::beg);
+
+	std::vector<unsigned char> data(static_cast<size_t>(fileSize));
+	if (file.read(reinterpret_cast<char *>(data.data()), fileSize).good() == false || data.size() < 0x34)
+		return false;
+
+	// Only little-endian binaries are supported, the ones of every supported platform
+	const bool is64Bit = (data[4] == 2);
+	Reader reader(data.data(), data.size());
+	reader.seek(16);
+	const unsigned int elfType = static_cast<unsigned int>(reader.unsignedValue(2));
+	if (data[5] != 1 || (elfType != ElfTypeExecutable && elfType != ElfTypeShared))
+		return false;
+
+	std::vector<Section> sections;
+	if (readSections(data, is64Bit, sections) == false)
+		return false;
+
+	sizes(Kind::FILE)[name] = data.size();
+	for (const Section &section : sections)
+	{
+		if (section.name.empty() == false && section.type != SectionTypeNoBits && section.size > 0)
+			sizes(Kind::SECTION)[name + "\t" + section.name] += section.size;
+	}
+
+	std::map<std::string, uint64_t> symbols;
+	std::map<std::string, uint64_t> fileSymbols;
+	readSymbols(data, is64Bit, sections, symbols, fileSymbols);
+	for (const auto &pair : symbols)
+		sizes(Kind::SYMBOL)[name + "\t" + pair.first] += pair.second;
+
+	std::map<std::string, uint64_t> units;
+	readUnits(data, sections, units);
+	// Without readable debug information, like in distributed or compressed binaries, only the local symbols can be attributed to their unit
+	if (units.empty())
+		units.swap(fileSymbols);
+	for (const auto &pair : units)
+		sizes(Kind::UNIT)[name + "\t" + pair.first] += pair.second;
+
+	return true;
+}
+
+bool BinarySize::load(const std::string &filename)
+{
+	std::ifstream file(filename);
+	if (file.is_open() == false)
+		return false;
+
+	for (unsigned int i = 0; i < NumKinds; i++)
+		sizes_[i].clear();
+
+	std::string line;
+	while (std::getline(file, line))
+	{
+		if (line.empty() == false && line.back() == '\r')
+			line.pop_back();
+		const size_t firstTab = line.find('\t');
+		const size_t lastTab = line.rfind('\t');
+		if (line.empty() || line[0] == '#' || firstTab == std::string::npos || lastTab == firstTab)
+			continue;
+
+		const std::string kind = line.substr(0, firstTab);
+		for (unsigned int i = 0; i < NumKinds; i++)
+		{
+			if (kind == kindNames[i])
+			{
+				std::string key = line.substr(firstTab + 1, lastTab - firstTab - 1);
+				// Binaries have an empty entry name
+				if (i == static_cast<unsigned int>(Kind::FILE) && key.empty() == false && key.back() == '\t')
+					key.pop_back();
+				sizes_[i][key] = strtoull(line.data() + lastTab + 1, nullptr, 10);
+			}
+		}
+	}
+
+	return true;
+}
+
+bool BinarySize::save(const std::string &filename) const
+{
+	std::ofstream file(filename, std::ios::trunc);
+	if (file.is_open() == false)
+		return false;
+
+	file << header << "\n";
+	for (unsigned int i = 0; i < NumKinds; i++)
+	{
+		for (const auto &pair : sizes_[i])
+			file << kindNames[i] << '\t' << pair.first << (i == static_cast<unsigned int>(Kind::FILE) ? "\t" : "") << '\t' << pair.second << "\n";
+	}
+
+	return file.good();
+}
+
+unsigned long long BinarySize::totalSize() const
+{
+	unsigned long long total = 0;
+	for (const auto &pair : sizes(Kind::FILE))
+		total += pair.second;
+	return total;
+}
+
+void BinarySize::printBreakdown(unsigned int numEntries) const
+{
+	const int MaxLength = 64;
+	char buffer[MaxLength];
+
+	Helpers::info("Binaries:");
+	for (const auto &pair : sizes(Kind::FILE))
+	{
+		snprintf(buffer, MaxLength, "%12s  ", formatSize(pair.second).data());
+		std::cout << buffer << pair.first << "\n";
+	}
+
+	const char *titles[] = { nullptr, "Largest sections:", "Largest symbols:", "Largest compilation units:" };
+	const bool withBinary = (numBinaries() > 1);
+	for (unsigned int i = static_cast<unsigned int>(Kind::SECTION); i < NumKinds; i++)
+	{
+		std::vector<std::pair<std::string, unsigned long long>> entries(sizes_[i].begin(), sizes_[i].end());
+		if (entries.empty())
+		{
+			if (i == static_cast<unsigned int>(Kind::UNIT))
+				Helpers::info(unitsUnavailable);
+			continue;
+		}
+
+		std::sort(entries.begin(), entries.end(), [](const std::pair<std::string, unsigned long long> &a, const std::pair<std::string, unsigned long long> &b) {
+			return (a.second != b.second) ? a.second > b.second : a.first < b.first;
+		});
+		if (entries.size() > numEntries)
+			entries.resize(numEntries);
+
+		Helpers::info(titles[i]);
+		for (const auto &entry : entries)
+		{
+			snprintf(buffer, MaxLength, "%12s  ", formatSize(entry.second).data());
+			std::cout << buffer << displayName(entry.first, withBinary) << "\n";
+		}
+	}
+	std::cout << std::flush;
+}
+
+void BinarySize::printTotalDelta(const BinarySize &baseline, const BinarySize &current)
+{
+	const int MaxLength = 128;
+	char buffer[MaxLength];
+
+	const long long totalDelta = static_cast<long long>(current.totalSize()) - static_cast<long long>(baseline.totalSize());
+	snprintf(buffer, MaxLength, "%s -> %s (%s, %+.2f%%)", formatSize(baseline.totalSize()).data(), formatSize(current.totalSize()).data(),
+	         formatDelta(totalDelta).data(), (baseline.totalSize() > 0) ? 100.0 * totalDelta / baseline.totalSize() : 0.0);
+	Helpers::info("Binary size since the last distribution: ", buffer);
+}
+
+void BinarySize::printDiff(const BinarySize &baseline, const BinarySize &current, unsigned int numEntries)
+{
+	const int MaxLength = 128;
+	char buffer[MaxLength];
+
+	printTotalDelta(baseline, current);
+
+	const char *titles[] = { "Binaries with the largest changes:", "Sections with the largest changes:", "Symbols with the largest changes:",
+		                     "Compilation units with the largest changes:" };
+	const bool withBinary = (current.numBinaries() > 1 || baseline.numBinaries() > 1);
+	for (unsigned int i = 0; i < NumKinds; i++)
+	{
+		// Entries missing on one side count as zero, so that additions and removals are shown
+		std::map<std::string, long long> deltas;
+		for (const auto &pair : baseline.sizes_[i])
+			deltas[pair.first] -= static_cast<long long>(pair.second);
+		for (const auto &pair : current.sizes_[i])
+			deltas[pair.first] += static_cast<long long>(pair.second);
+
+		std::vector<std::pair<std::string, long long>> entries;
+		for (const auto &pair : deltas)
+		{
+			if (pair.second != 0)
+				entries.push_back(pair);
+		}
+		if (entries.empty())
+		{
+			if (i == static_cast<unsigned int>(Kind::UNIT) && current.sizes_[i].empty())
+				Helpers::info(unitsUnavailable);
+			continue;
+		}
+
+		std::sort(entries.begin(), entries.end(), [](const std::pair<std::string, long long> &a, const std::pair<std::string, long long> &b) {
+			const long long absA = a.second < 0 ? -a.second : a.second;
+			const long long absB = b.second < 0 ? -b.second : b.second;
+			return (absA != absB) ? absA > absB : a.first < b.first;
+		});
+		if (entries.size() > numEntries)
+			entries.resize(numEntries);
+
+		Helpers::info(titles[i]);
+		for (const auto &entry : entries)
+		{
+			const char *status = "";
+			if (baseline.sizes_[i].count(entry.first) == 0)
+				status = "  (new)";
+			else if (current.sizes_[i].count(entry.first) == 0)
+				status = "  (removed)";
+			snprintf(buffer, MaxLength, "%12s  ", formatDelta(entry.second).data());
+			std::cout << buffer << displayName(entry.first, withBinary) << status << "\n";
+		}
+	}
+	std::cout << std::flush;
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <string>
+#include <map>
+
+/// The size of the sections, symbols and compilation units of the ELF binaries in a directory
+class BinarySize
+{
+  public:
+	enum class Kind
+	{
+		FILE,
+		SECTION,
+		SYMBOL,
+		UNIT
+	};
+
+	/// Returns the directory that keeps the sizes measured by the last distribution of every target
+	static const char *snapshotsDir() { return "ncline-size"; }
+	static std::string snapshotFile(const std::string &distDir);
+
+	/// Adds the executables and shared libraries found in a directory, returns the number of them
+	unsigned int addDirectory(const std::string &directory);
+	/// Adds an executable or a shared library under a name, returns false if it is not an ELF file of those types
+	bool addElfFile(const std::string &filename, const std::string &name);
+
+	bool load(const std::string &filename);
+	bool save(const std::string &filename) const;
+
+	inline unsigned int numBinaries() const { return static_cast<unsigned int>(sizes_[0].size()); }
+	/// Returns the sum of the file sizes of the binaries, in bytes
+	unsigned long long totalSize() const;
+
+	/// Prints the largest sections, symbols and compilation units
+	void printBreakdown(unsigned int numEntries) const;
+	/// Prints the change of the total size of the binaries
+	static void printTotalDelta(const BinarySize &baseline, const BinarySize &current);
+	/// Prints the sections, symbols and compilation units whose size changed the most
+	static void printDiff(const BinarySize &baseline, const BinarySize &current, unsigned int numEntries);
+
+  private:
+	static const unsigned int NumKinds = 4;
+	/// The sizes in bytes of every kind of entry, by binary name and entry name separated by a tab
+	std::map<std::string, unsigned long long> sizes_[NumKinds];
+
+	inline std::map<std::string, unsigned long long> &sizes(Kind kind) { return sizes_[static_cast<unsigned int>(kind)]; }
+	inline const std::map<std::string, unsigned long long> &sizes(Kind kind) const { return sizes_[static_cast<unsigned int>(kind)]; }
+};
@@ -0,0 +1,425 @@
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include "BuildHistory.h"
+#include "GitCommand.h"
+#include "NinjaLog.h"
+#include "FileSystem.h"
+#include "Settings.h"
+#include "Configuration.h"
+#include "Helpers.h"
+
+#ifndef _WIN32
+	#include <sys/resource.h>
+#endif
+
+namespace {
+
+/// The first line of the file, a history with a different one is not read
+const char *header = "# ncline build history v1";
+const unsigned int NumFields = 16;
+/// Number of comparable previous runs used to compute the rolling median
+const unsigned int MedianWindow = 10;
+/// Minimum number of comparable previous runs needed to flag a regression
+const unsigned int MinComparableRuns = 3;
+
+const char *modeToString(Settings::Mode mode)
+{
+	return (mode == Settings::Mode::DIST) ? "dist" : "build";
+}
+
+const char *platformToString(Configuration::Platform platform)
+{
+	switch (platform)
+	{
+		case Configuration::Platform::DESKTOP: return "desktop";
+		case Configuration::Platform::ANDROID: return "android";
+		case Configuration::Platform::EMSCRIPTEN: return "emscripten";
+		case Configuration::Platform::UNSPECIFIED: return "unspecified";
+	}
+	return nullptr;
+}
+
+/// Returns the CPU time spent by the terminated child processes, in milliseconds
+unsigned long int childrenCpuTime()
+{
+#ifndef _WIN32
+	struct rusage usage;
+	if (getrusage(RUSAGE_CHILDREN, &usage) != 0)
+		return 0;
+
+	return (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000UL +
+	       (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1000UL;
+#else
+	return 0;
+#endif
+}
+
+/// Retrieves the head of a repository only if it exists on disk
+void retrieveHead(GitCommand &git, const char *repositoryDir, std::string &head)
+{
+	if (fs::exists(fs::joinPath(repositoryDir, ".git").data()))
+		git.retrieveHead(repositoryDir, head);
+}
+
+void appendOption(std::string &options, const std::string &option)
+{
+	if (options.empty() == false)
+		options += ",";
+	options += option;
+}
+
+/// Returns the difference between two values as a percentage of the first one
+float percentDelta(unsigned int before, unsigned int after)
+{
+	return (before > 0) ? 100.0f * (static_cast<float>(after) - before) / before : 0.0f;
+}
+
+bool isSameBuild(const BuildHistory::Run &a, const BuildHistory::Run &b)
+{
+	return (a.mode == b.mode && a.target == b.target && a.buildType == b.buildType && a.platform == b.platform && a.compiler == b.compiler);
+}
+
+/// Runs with a similar number of executed steps are compared with each other
+unsigned int changeSize(unsigned int numSteps)
+{
+	unsigned int digits = 0;
+	for (; numSteps > 0; numSteps /= 10)
+		digits++;
+	return digits;
+}
+
+bool isComparable(const BuildHistory::Run &a, const BuildHistory::Run &b)
+{
+	return (isSameBuild(a, b) && a.options == b.options && changeSize(a.numSteps) == changeSize(b.numSteps));
+}
+
+const std::string &emptyAsDash(const std::string &string)
+{
+	static const std::string dash = "-";
+	return string.empty() ? dash : string;
+}
+
+bool splitFields(const std::string &line, std::vector<std::string> &fields)
+{
+	fields.clear();
+	size_t start = 0;
+	size_t tab = line.find('\t');
+	while (tab != std::string::npos)
+	{
+		fields.push_back(line.substr(start, tab - start));
+		start = tab + 1;
+		tab = line.find('\t', start);
+	}
+	fields.push_back(line.substr(start));
+
+	return (fields.size() == NumFields);
+}
+
+}
+
+///////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////
+
+const char *BuildHistory::compilerToString()
+{
+#if defined(_WIN32)
+	if (config().withMinGW() == false)
+		return "msvc";
+#elif defined(__APPLE__)
+	return "appleclang";
+#endif
+	switch (config().compiler())
+	{
+		case Configuration::Compiler::GCC: return "gcc";
+		case Configuration::Compiler::CLANG: return "clang";
+		case Configuration::Compiler::UNSPECIFIED: return "default";
+	}
+	return nullptr;
+}
+
+std::string BuildHistory::optionsToString(const Settings &settings)
+{
+	std::string options;
+	if (settings.target() == Settings::Target::LIBS)
+		return options;
+
+	// Distribution builds use their own presets
+	if (settings.mode() != Settings::Mode::DIST)
+	{
+		if (config().hasUnityBuild() && config().withUnityBuild())
+			appendOption(options, "unity" + std::to_string(config().unityBatchSize()));
+		if (config().hasPrecompiledHeaders() && config().withPrecompiledHeaders() == false)
+			appendOption(options, "nopch");
+	}
+	if (settings.mode() == Settings::Mode::DIST || settings.buildType() == Settings::BuildType::RELEASE)
+	{
+		if (config().lto() == Configuration::Lto::FULL)
+			appendOption(options, "lto");
+		else if (config().lto() == Configuration::Lto::THIN)
+			appendOption(options, "thinlto");
+	}
+	return options;
+}
+
+void BuildHistory::beginRun(Run &run, const Settings &settings, unsigned int jobs)
+{
+	run.timestamp = static_cast<long long int>(time(nullptr));
+	run.mode = modeToString(settings.mode());
+	run.target = Settings::targetToString(settings.target());
+	run.buildType = (settings.mode() == Settings::Mode::DIST) ? "release" : Settings::buildTypeToString(settings.buildType());
+	run.platform = platformToString(config().platform());
+	run.compiler = compilerToString();
+	run.options = optionsToString(settings);
+	run.jobs = jobs;
+
+	run.startTime = std::chrono::steady_clock::now();
+	run.startCpuTime = childrenCpuTime();
+}
+
+void BuildHistory::endRun(Run &run, GitCommand &git, unsigned int numSteps)
+{
+	const auto elapsed = std::chrono::steady_clock::now() - run.startTime;
+	run.wallTime = static_cast<unsigned int>(std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count());
+	run.cpuTime = static_cast<unsigned int>(childrenCpuTime() - run.startCpuTime);
+	run.numSteps = numSteps;
+
+	// A game is built against the engine and the engine against the libraries, so the heads of all of them describe the build
+	if (config().platform() == Configuration::Platform::ANDROID)
+		retrieveHead(git, Helpers::nCineAndroidLibrariesSourceDir(), run.librariesHead);
+	else
+		retrieveHead(git, Helpers::nCineLibrariesSourceDir(), run.librariesHead);
+	retrieveHead(git, Helpers::nCineSourceDir(), run.engineHead);
+
+	std::string gameName;
+	if (config().gameName(gameName) && gameName.empty() == false)
+		retrieveHead(git, gameName.data(), run.gameHead);
+}
+
+void BuildHistory::setLinkStats(Run &run, const NinjaLog &ninjaLog, const std::string &buildDir)
+{
+	run.linkTime = ninjaLog.linkTime();
+
+	unsigned long long binarySize = 0;
+	for (const std::string &output : ninjaLog.linkOutputs())
+	{
+		// Static libraries are linked again in the executables
+		if (fs::endsWith(output, ".a") || fs::endsWith(output, ".lib"))
+			continue;
+		binarySize += fs::fileSize(fs::joinPath(buildDir, output).data());
+	}
+	run.binarySize = static_cast<unsigned int>(binarySize / 1024);
+}
+
+void BuildHistory::printLinkStats(const Run &run)
+{
+	if (run.linkTime == 0 && run.binarySize == 0)
+		return;
+
+	const int MaxLength = 128;
+	char buffer[MaxLength];
+	snprintf(buffer, MaxLength, "%.2f MiB, %.1f s link time", run.binarySize / 1024.0f, run.linkTime / 1000.0f);
+	Helpers::info("Linked binaries: ", buffer);
+}
+
+bool BuildHistory::append(const Run &run) const
+{
+	std::ifstream existingFile(historyFile());
+	const bool isNew = (existingFile.is_open() == false);
+	existingFile.close();
+
+	std::ofstream file(historyFile(), std::ios::app);
+	if (file.is_open() == false)
+		return false;
+
+	if (isNew)
+		file << header << "\n";
+
+	file << run.timestamp << '\t' << run.mode << '\t' << run.target << '\t' << run.buildType << '\t'
+	     << run.platform << '\t' << run.compiler << '\t' << run.jobs << '\t' << run.wallTime << '\t'
+	     << run.cpuTime << '\t' << run.numSteps << '\t' << emptyAsDash(run.librariesHead) << '\t'
+	     << emptyAsDash(run.engineHead) << '\t' << emptyAsDash(run.gameHead) << '\t' << emptyAsDash(run.options) << '\t'
+	     << run.linkTime << '\t' << run.binarySize << "\n";
+
+	return file.good();
+}
+
+bool BuildHistory::load()
+{
+	std::ifstream file(historyFile());
+	if (file.is_open() == false)
+		return false;
+
+	runs_.clear();
+	std::string line;
+	if (!std::getline(file, line) || Helpers::trim(line) != header)
+		return false;
+
+	std::vector<std::string> fields;
+	while (std::getline(file, line))
+	{
+		if (line.empty() || line[0] == '#' || splitFields(line, fields) == false)
+			continue;
+
+		Run run;
+		run.timestamp = strtoll(fields[0].data(), nullptr, 10);
+		run.mode = fields[1];
+		run.target = fields[2];
+		run.buildType = fields[3];
+		run.platform = fields[4];
+		run.compiler = fields[5];
+		run.jobs = strtoul(fields[6].data(), nullptr, 10);
+		run.wallTime = strtoul(fields[7].data(), nullptr, 10);
+		run.cpuTime = strtoul(fields[8].data(), nullptr, 10);
+		run.numSteps = strtoul(fields[9].data(), nullptr, 10);
+		run.librariesHead = fields[10];
+		run.engineHead = fields[11];
+		run.gameHead = fields[12];
+		run.options = (fields[13] == "-") ? "" : fields[13];
+		run.linkTime = strtoul(fields[14].data(), nullptr, 10);
+		run.binarySize = strtoul(fields[15].data(), nullptr, 10);
+		runs_.push_back(run);
+	}
+
+	return true;
+}
+
+void BuildHistory::printReport(const char *target, unsigned int numEntries, unsigned int thresholdPercent) const
+{
+	assert(target);
+
+	std::vector<unsigned int> indices;
+	for (unsigned int i = 0; i < runs_.size(); i++)
+	{
+		if (runs_[i].target == target)
+			indices.push_back(i);
+	}
+	if (indices.size() > numEntries)
+		indices.erase(indices.begin(), indices.end() - numEntries);
+
+	if (indices.empty())
+	{
+		Helpers::info("No recorded runs for the target: ", target);
+		return;
+	}
+
+	const int MaxLength = 512;
+	char buffer[MaxLength];
+	unsigned int numRegressions = 0;
+	for (unsigned int index : indices)
+	{
+		const Run &run = runs_[index];
+		const time_t timestamp = static_cast<time_t>(run.timestamp);
+		struct tm tstruct;
+#ifdef _WIN32
+		localtime_s(&tstruct, &timestamp);
+#else
+		localtime_r(&timestamp, &tstruct);
+#endif
+		char timeString[32];
+		strftime(timeString, sizeof(timeString), "%Y-%m-%d %H:%M", &tstruct);
+
+		const std::string &head = (run.target == "libs") ? run.librariesHead : (run.target == "engine" ? run.engineHead : run.gameHead);
+		snprintf(buffer, MaxLength, "%s  %-5s %-14s %-10s %-10s %-16s %3u jobs %9.1f s wall %9.1f s CPU %8.1f s link %8u KiB %6u steps  %s",
+		         timeString, run.mode.data(), run.buildType.data(), run.platform.data(), run.compiler.data(), emptyAsDash(run.options).data(),
+		         run.jobs, run.wallTime / 1000.0f, run.cpuTime / 1000.0f, run.linkTime / 1000.0f, run.binarySize, run.numSteps, head.data());
+		std::cout << buffer;
+
+		unsigned int median = 0;
+		if (isRegression(index, thresholdPercent, median))
+		{
+			snprintf(buffer, MaxLength, "  SLOWER: +%.0f%% over the median of %.1f s", 100.0f * (run.wallTime - median) / median, median / 1000.0f);
+			std::cout << buffer;
+			numRegressions++;
+		}
+		std::cout << "\n";
+	}
+	std::cout << std::flush;
+
+	if (numRegressions > 0)
+	{
+		snprintf(buffer, MaxLength, "%u runs slower than the rolling median by more than %u%%", numRegressions, thresholdPercent);
+		Helpers::error("Build time regressions: ", buffer);
+	}
+}
+
+void BuildHistory::printOptionsDelta(const Run &run, bool anyPrevious) const
+{
+	const Run *previous = nullptr;
+	for (unsigned int i = static_cast<unsigned int>(runs_.size()); i > 0; i--)
+	{
+		// Only two builds from scratch, or two rebuilds after a similar change, can be compared
+		if (isSameBuild(runs_[i - 1], run) && changeSize(runs_[i - 1].numSteps) == changeSize(run.numSteps))
+		{
+			// Without an explicit request only a change of settings since the previous run is reported
+			if (runs_[i - 1].options != run.options)
+				previous = &runs_[i - 1];
+			if (previous != nullptr || anyPrevious == false)
+				break;
+		}
+	}
+
+	if (previous == nullptr)
+	{
+		if (anyPrevious)
+			Helpers::info("No recorded run of the same build, with a similar number of steps and different unity, precompiled header or link-time optimization settings");
+		return;
+	}
+
+	const int MaxLength = 256;
+	char buffer[MaxLength];
+	snprintf(buffer, MaxLength, "%-16s %9.1f s wall %9.1f s CPU %8.1f s link %8u KiB %6u steps", emptyAsDash(previous->options).data(),
+	         previous->wallTime / 1000.0f, previous->cpuTime / 1000.0f, previous->linkTime / 1000.0f, previous->binarySize, previous->numSteps);
+	Helpers::info("Previous settings: ", buffer);
+	snprintf(buffer, MaxLength, "%-16s %9.1f s wall %9.1f s CPU %8.1f s link %8u KiB %6u steps", emptyAsDash(run.options).data(),
+	         run.wallTime / 1000.0f, run.cpuTime / 1000.0f, run.linkTime / 1000.0f, run.binarySize, run.numSteps);
+	Helpers::info("Current settings:  ", buffer);
+
+	if (previous->wallTime > 0 && previous->cpuTime > 0)
+	{
+		snprintf(buffer, MaxLength, "%+.1f%% wall time, %+.1f%% CPU time", percentDelta(previous->wallTime, run.wallTime),
+		         percentDelta(previous->cpuTime, run.cpuTime));
+		Helpers::info("Compile time delta: ", buffer);
+	}
+	if (previous->linkTime > 0 || run.linkTime > 0)
+	{
+		snprintf(buffer, MaxLength, "%+.1f s link time", (static_cast<float>(run.linkTime) - previous->linkTime) / 1000.0f);
+		Helpers::info("Link time delta: ", buffer);
+	}
+	// Incremental builds only link the binaries that changed
+	if (previous->binarySize > 0 && run.binarySize > 0)
+	{
+		snprintf(buffer, MaxLength, "%+d KiB (%+.1f%%)", static_cast<int>(run.binarySize) - static_cast<int>(previous->binarySize),
+		         percentDelta(previous->binarySize, run.binarySize));
+		Helpers::info("Binary size delta: ", buffer);
+	}
+}
+
+///////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+///////////////////////////////////////////////////////////
+
+bool BuildHistory::isRegression(unsigned int index, unsigned int thresholdPercent, unsigned int &median) const
+{
+	assert(index < runs_.size());
+
+	const Run &run = runs_[index];
+	std::vector<unsigned int> wallTimes;
+	for (unsigned int i = index; i > 0 && wallTimes.size() < MedianWindow; i--)
+	{
+		if (isComparable(runs_[i - 1], run))
+			wallTimes.push_back(runs_[i - 1].wallTime);
+	}
+
+	if (wallTimes.size() < MinComparableRuns)
+		return false;
+
+	std::sort(wallTimes.begin(), wallTimes.end());
+	median = wallTimes[wallTimes.size() / 2];
+	return (median > 0 && run.wallTime > median + median * thresholdPercent / 100);
+}
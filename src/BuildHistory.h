@@ -0,0 +1,69 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <chrono>
+
+class Settings;
+class GitCommand;
+class NinjaLog;
+
+/// An append-only record of the build and distribution runs
+class BuildHistory
+{
+  public:
+	struct Run
+	{
+		long long int timestamp = 0;
+		std::string mode;
+		std::string target;
+		std::string buildType;
+		std::string platform;
+		std::string compiler;
+		/// The unity build, precompiled header and link-time optimization settings of the configuration
+		std::string options;
+		/// Time spent linking, in milliseconds, and size of the linked executables and shared libraries, in kilobytes
+		unsigned int linkTime = 0;
+		unsigned int binarySize = 0;
+		unsigned int jobs = 0;
+		/// Elapsed and CPU times of the run, in milliseconds
+		unsigned int wallTime = 0;
+		unsigned int cpuTime = 0;
+		/// Number of build steps executed by Ninja, zero if unknown
+		unsigned int numSteps = 0;
+		std::string librariesHead;
+		std::string engineHead;
+		std::string gameHead;
+
+		std::chrono::steady_clock::time_point startTime;
+		unsigned long int startCpuTime = 0;
+	};
+
+	static const char *historyFile() { return "ncline-history.tsv"; }
+	/// Returns the name of the compiler used by the builds, as recorded in the history
+	static const char *compilerToString();
+	/// Returns the unity build, precompiled header and link-time optimization settings of a build, as recorded in the history
+	static std::string optionsToString(const Settings &settings);
+
+	/// Fills the description of a run and starts measuring it
+	static void beginRun(Run &run, const Settings &settings, unsigned int jobs);
+	/// Stops measuring a run and retrieves the commits of the repositories found on disk
+	static void endRun(Run &run, GitCommand &git, unsigned int numSteps);
+	/// Retrieves the link time of the last Ninja run and the size of all the linked files of a build directory
+	static void setLinkStats(Run &run, const NinjaLog &ninjaLog, const std::string &buildDir);
+	static void printLinkStats(const Run &run);
+
+	bool append(const Run &run) const;
+	bool load();
+
+	/// Prints the last runs of a target, flagging the ones slower than the rolling median of comparable runs
+	void printReport(const char *target, unsigned int numEntries, unsigned int thresholdPercent) const;
+	/// Compares a run with the previous one of the same build if its settings were different, or with the last one with different settings
+	/// Only the runs that executed a number of steps of the same order of magnitude are considered
+	void printOptionsDelta(const Run &run, bool anyPrevious) const;
+
+  private:
+	std::vector<Run> runs_;
+
+	bool isRegression(unsigned int index, unsigned int thresholdPercent, unsigned int &median) const;
+};
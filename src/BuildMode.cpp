@@ -1,21 +1,40 @@
 #include <cassert>
 #include "BuildMode.h"
+#include "GitCommand.h"
 #include "CMakeCommand.h"
+#include "CacheCommand.h"
+#include "JobCount.h"
+#include "JobServer.h"
+#include "BuildHistory.h"
+#include "NinjaLog.h"
+#include "BuildProgress.h"
+#include "BinaryCache.h"
+#include "ConfMode.h"
 #include "FileSystem.h"
 #include "Settings.h"
 #include "Configuration.h"
+#include "Process.h"
 #include "Helpers.h"
 
 namespace {
 
-const char *settingsToBuildConfigString(Settings::BuildType buildType)
+/// Number of entries in the lists of the build summary
+const unsigned int SummaryEntries = 5;
+
+void printCacheStats(unsigned int hits, unsigned int misses)
 {
-	switch (buildType)
-	{
-		case Settings::BuildType::DEBUG: return "debug";
-		case Settings::BuildType::RELEASE: return "release";
-	}
-	return nullptr;
+	const unsigned int total = hits + misses;
+	const float hitRate = (total > 0) ? 100.0f * hits / total : 0.0f;
+
+	const int MaxLength = 128;
+	char buffer[MaxLength];
+	snprintf(buffer, MaxLength, "%u hits, %u misses (%.1f%% hit rate)", hits, misses, hitRate);
+	Helpers::info("Compiler cache statistics for this build: ", buffer);
+}
+
+bool hasNinjaLog(const CMakeCommand &cmake)
+{
+	return (config().withNinja() && cmake.ninjaFound() && CMakeCommand::generatorIsVisualStudio() == false && Process::dryRun == false);
 }
 
 void buildLibraries(CMakeCommand &cmake, const Settings &settings)
@@ -23,11 +42,11 @@ void buildLibraries(CMakeCommand &cmake, const Settings &settings)
 	Helpers::info("Build the libraries");
 
 	std::string buildDir = Helpers::nCineLibrariesSourceDir();
-	Helpers::buildDir(buildDir);
+	Helpers::buildDir(buildDir, settings);
 
 	bool hasBuilt = false;
 	if (CMakeCommand::generatorIsMultiConfig())
-		cmake.buildConfig(buildDir.data(), settingsToBuildConfigString(settings.buildType()));
+		cmake.buildConfig(buildDir.data(), Settings::buildTypeToConfigString(settings.buildType()));
 	else
 		hasBuilt = cmake.build(buildDir.data());
 
@@ -54,12 +73,35 @@ void buildAndroidLibraries(CMakeCommand &cmake, const Settings &settings)
 	Helpers::info("Build the Android libraries");
 
 	std::string buildDir = Helpers::nCineAndroidLibrariesSourceDir();
-	Helpers::buildDir(buildDir);
+	Helpers::buildDir(buildDir, settings);
 
 	cmake.build(buildDir.data());
 }
 
-void buildEngine(CMakeCommand &cmake, const Settings &settings)
+void setEngineDir(const std::string &engineDir)
+{
+	std::string absolutePath = fs::currentDir();
+	absolutePath = fs::joinPath(absolutePath, engineDir);
+	if (fs::isDirectory(absolutePath.data()))
+	{
+		config().setEngineDir(absolutePath);
+		config().save();
+		Helpers::info("Set 'nCine_DIR' CMake variable to: ", absolutePath.data());
+	}
+}
+
+/// Returns true if `nCine_DIR` points to a build directory, as it happens after a successful build
+bool hasBuiltLocally(const std::string &buildDir)
+{
+	std::string engineDir;
+	if (config().engineDir(engineDir) == false)
+		return false;
+
+	const std::string absolutePath = fs::joinPath(fs::currentDir(), buildDir);
+	return (engineDir == absolutePath && fs::isDirectory(absolutePath.data()));
+}
+
+void buildEngine(GitCommand &git, CMakeCommand &cmake, const CacheCommand &cache, const Settings &settings)
 {
 	if (config().platform() == Configuration::Platform::ANDROID)
 		cmake.addNMakeDirToPath();
@@ -67,24 +109,34 @@ void buildEngine(CMakeCommand &cmake, const Settings &settings)
 	Helpers::info("Build the engine");
 
 	std::string buildDir = Helpers::nCineSourceDir();
-	Helpers::buildDir(buildDir);
+	Helpers::buildDir(buildDir, settings);
 
+	BinaryCache binaryCache(git, cmake);
+	if (binaryCache.enabled() && Process::dryRun == false)
+	{
+		std::string arguments;
+		ConfMode::engineArguments(arguments, cmake, cache, settings);
+		std::string engineDir;
+		// An incremental build of a local build directory is cheaper than copying a cached one
+		const bool canRestore = (hasBuiltLocally(buildDir) == false);
+		if (binaryCache.computeKey(buildDir, arguments, settings) && canRestore && binaryCache.restore(buildDir, engineDir))
+		{
+			setEngineDir(engineDir);
+			return;
+		}
+	}
+
+	const char *buildConfig = CMakeCommand::generatorIsMultiConfig() ? Settings::buildTypeToConfigString(settings.buildType()) : nullptr;
 	bool hasBuilt = false;
-	if (CMakeCommand::generatorIsMultiConfig())
-		hasBuilt = cmake.buildConfig(buildDir.data(), settingsToBuildConfigString(settings.buildType()));
+	if (buildConfig)
+		hasBuilt = cmake.buildConfig(buildDir.data(), buildConfig);
 	else
 		hasBuilt = cmake.build(buildDir.data());
 
 	if (hasBuilt) // Overwrite `nCine_DIR` variable in any case
 	{
-		std::string absolutePath = fs::currentDir();
-		absolutePath = fs::joinPath(absolutePath, buildDir);
-		if (fs::isDirectory(absolutePath.data()))
-		{
-			config().setEngineDir(absolutePath);
-			config().save();
-			Helpers::info("Set 'nCine_DIR' CMake variable to: ", absolutePath.data());
-		}
+		setEngineDir(buildDir);
+		binaryCache.store(buildDir, buildConfig);
 	}
 }
 
@@ -101,24 +153,16 @@ void buildGame(CMakeCommand &cmake, const Settings &settings, const std::string
 	Helpers::info("Build the game: ", gameName.data());
 
 	std::string buildDir = gameName;
-	Helpers::buildDir(buildDir);
+	Helpers::buildDir(buildDir, settings);
 
 	if (CMakeCommand::generatorIsMultiConfig())
-		cmake.buildConfig(buildDir.data(), settingsToBuildConfigString(settings.buildType()));
+		cmake.buildConfig(buildDir.data(), Settings::buildTypeToConfigString(settings.buildType()));
 	else
 		cmake.build(buildDir.data());
 }
 
-}
-
-///////////////////////////////////////////////////////////
-// PUBLIC FUNCTIONS
-///////////////////////////////////////////////////////////
-
-void BuildMode::perform(CMakeCommand &cmake, const Settings &settings)
+void buildTarget(GitCommand &git, CMakeCommand &cmake, const CacheCommand &cache, const Settings &settings)
 {
-	assert(settings.mode() == Settings::Mode::BUILD);
-
 	switch (settings.target())
 	{
 		case Settings::Target::LIBS:
@@ -128,7 +172,7 @@ void BuildMode::perform(CMakeCommand &cmake, const Settings &settings)
 				buildLibraries(cmake, settings);
 			break;
 		case Settings::Target::ENGINE:
-			buildEngine(cmake, settings);
+			buildEngine(git, cmake, cache, settings);
 			break;
 		case Settings::Target::GAME:
 		{
@@ -140,3 +184,87 @@ void BuildMode::perform(CMakeCommand &cmake, const Settings &settings)
 		}
 	}
 }
+
+}
+
+///////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////
+
+void BuildMode::perform(GitCommand &git, CMakeCommand &cmake, CacheCommand &cache, const Settings &settings)
+{
+	assert(settings.mode() == Settings::Mode::BUILD);
+
+	std::string jobsReason;
+	cmake.setJobs(JobCount::compute(settings.jobs(), jobsReason));
+	JobCount::print(cmake.jobs(), jobsReason);
+	const unsigned int jobs = cmake.jobs();
+
+	JobServer jobServer;
+	jobServer.start(cmake);
+
+	unsigned int hitsBefore = 0;
+	unsigned int missesBefore = 0;
+	const bool hasCacheStats = cache.retrieveStats(hitsBefore, missesBefore);
+
+	// Loaded before the new runs are appended, to compare them with the previous ones
+	BuildHistory history;
+	history.load();
+	BuildProgress progress;
+	const bool withProgress = (config().withCompactProgress() && BuildProgress::isSupported() && Process::dryRun == false);
+	if (withProgress)
+	{
+		// A status prefix that can be parsed, Ninja prints every step on its own line when the output is not a terminal
+		Helpers::setEnvironment("NINJA_STATUS", BuildProgress::ninjaStatus());
+		cmake.setProgress(&progress);
+	}
+
+	// Multiple build types are built one after the other, as every build already uses all the cores
+	Settings buildTypeSettings(settings);
+	for (Settings::BuildType buildType : settings.buildTypes())
+	{
+		buildTypeSettings.setBuildType(buildType);
+
+		NinjaLog ninjaLog;
+		const std::string buildDir = Helpers::targetBuildDir(buildTypeSettings);
+		const std::string logFile = NinjaLog::logFile(buildDir);
+		const bool withNinjaLog = hasNinjaLog(cmake);
+		const unsigned int numRecords = (withNinjaLog && ninjaLog.load(logFile.data())) ? ninjaLog.numRecords() : 0;
+
+		BuildHistory::Run run;
+		BuildHistory::beginRun(run, buildTypeSettings, jobs);
+		if (withProgress)
+			progress.begin(ninjaLog, jobs);
+		buildTarget(git, cmake, cache, buildTypeSettings);
+		if (withProgress)
+			progress.end();
+
+		// Nothing is appended to the log if everything was already up to date
+		unsigned int numSteps = 0;
+		bool withLinkStats = false;
+		if (withNinjaLog && ninjaLog.load(logFile.data()) && ninjaLog.numRecords() != numRecords)
+		{
+			ninjaLog.printReport(SummaryEntries);
+			numSteps = ninjaLog.steps().size();
+			withLinkStats = true;
+		}
+
+		if (Process::dryRun == false)
+		{
+			BuildHistory::endRun(run, git, numSteps);
+			if (withLinkStats)
+			{
+				BuildHistory::setLinkStats(run, ninjaLog, buildDir);
+				BuildHistory::printLinkStats(run);
+			}
+			if (history.append(run) == false)
+				Helpers::error("Cannot record the build in the history: ", BuildHistory::historyFile());
+			history.printOptionsDelta(run, settings.withStats());
+		}
+	}
+
+	unsigned int hitsAfter = 0;
+	unsigned int missesAfter = 0;
+	if (hasCacheStats && cache.retrieveStats(hitsAfter, missesAfter))
+		printCacheStats(hitsAfter - hitsBefore, missesAfter - missesBefore);
+}
@@ -0,0 +1,212 @@
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include "BuildProgress.h"
+#include "NinjaLog.h"
+#include "Helpers.h"
+
+#ifdef _WIN32
+	#include <io.h>
+#else
+	#include <unistd.h>
+#endif
+
+namespace {
+
+/// The status line is kept short enough not to wrap on most terminals
+const unsigned int MaxStatusLength = 100;
+
+void formatDuration(float seconds, char *dest, size_t size)
+{
+	if (seconds < 0.0f)
+		snprintf(dest, size, "--");
+	else
+	{
+		const unsigned int total = static_cast<unsigned int>(seconds + 0.5f);
+		if (total >= 3600)
+			snprintf(dest, size, "%uh%02um", total / 3600, (total % 3600) / 60);
+		else if (total >= 60)
+			snprintf(dest, size, "%um%02us", total / 60, total % 60);
+		else
+			snprintf(dest, size, "%us", total);
+	}
+}
+
+}
+
+///////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////
+
+bool BuildProgress::isSupported()
+{
+#ifdef _WIN32
+	return (_isatty(_fileno(stdout)) != 0);
+#else
+	return (isatty(fileno(stdout)) != 0);
+#endif
+}
+
+void BuildProgress::begin(const NinjaLog &ninjaLog, unsigned int jobs)
+{
+	startTime_ = std::chrono::steady_clock::now();
+	jobs_ = (jobs > 0) ? jobs : 1;
+
+	pendingDurations_ = ninjaLog.durations();
+	pendingDuration_ = 0;
+	for (const auto &pair : pendingDurations_)
+		pendingDuration_ += pair.second;
+	meanDuration_ = pendingDurations_.empty() ? 0.0f : pendingDuration_ / static_cast<float>(pendingDurations_.size());
+
+	finished_ = 0;
+	total_ = 0;
+	running_ = 0;
+	percent_ = 0;
+	description_.clear();
+	statusLength_ = 0;
+}
+
+void BuildProgress::processLine(const char *line)
+{
+	std::string text(line);
+	while (text.empty() == false && (text.back() == '\n' || text.back() == '\r'))
+		text.pop_back();
+
+	unsigned int finished = 0;
+	unsigned int total = 0;
+	unsigned int running = 0;
+	unsigned int percent = 0;
+	int descriptionStart = 0;
+
+	if (sscanf(text.data(), "[%u/%u %u] %n", &finished, &total, &running, &descriptionStart) == 3 && descriptionStart > 0)
+	{
+		// The status set by the `NINJA_STATUS` environment variable
+		finished_ = finished;
+		total_ = total;
+		running_ = running;
+		percent_ = (total > 0) ? 100 * finished / total : 0;
+		description_ = text.substr(descriptionStart);
+		finishStep(description_);
+		printStatus();
+	}
+	else if (sscanf(text.data(), "[%u%%] %n", &percent, &descriptionStart) == 1 && descriptionStart > 0)
+	{
+		// The percentage printed by the Makefile generators
+		percent_ = percent;
+		description_ = text.substr(descriptionStart);
+		printStatus();
+	}
+	else
+	{
+		// Compiler warnings and errors are printed in full
+		const bool hadStatus = (statusLength_ > 0);
+		clearStatus();
+		std::cout << text << "\n";
+		if (hadStatus)
+			printStatus();
+		else
+			std::cout << std::flush;
+	}
+}
+
+void BuildProgress::end()
+{
+	const bool hadProgress = (total_ > 0 || percent_ > 0);
+	clearStatus();
+
+	if (hadProgress)
+	{
+		const int MaxLength = 64;
+		char buffer[MaxLength];
+		char duration[MaxLength];
+		formatDuration(elapsedSeconds(), duration, MaxLength);
+		if (total_ > 0)
+			snprintf(buffer, MaxLength, "%u/%u steps in %s", finished_, total_, duration);
+		else
+			snprintf(buffer, MaxLength, "%u%% in %s", percent_, duration);
+		Helpers::info("Build progress: ", buffer);
+	}
+}
+
+///////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+///////////////////////////////////////////////////////////
+
+void BuildProgress::finishStep(const std::string &description)
+{
+	// Ninja prints the status of a step when it finishes if the output is not a terminal
+	const size_t space = description.rfind(' ');
+	const std::string output = (space != std::string::npos) ? description.substr(space + 1) : description;
+
+	auto it = pendingDurations_.find(output);
+	if (it != pendingDurations_.end())
+	{
+		pendingDuration_ -= it->second;
+		pendingDurations_.erase(it);
+	}
+}
+
+float BuildProgress::elapsedSeconds() const
+{
+	const auto elapsed = std::chrono::steady_clock::now() - startTime_;
+	return std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count() / 1000.0f;
+}
+
+float BuildProgress::remainingSeconds() const
+{
+	if (total_ > 0)
+	{
+		const unsigned int remaining = total_ - finished_;
+		if (meanDuration_ > 0.0f)
+		{
+			// After a clean every recorded step runs again, while an incremental build only runs some of them
+			float remainingDuration = 0.0f;
+			if (pendingDurations_.size() <= remaining)
+				remainingDuration = pendingDuration_ + (remaining - pendingDurations_.size()) * meanDuration_;
+			else
+				remainingDuration = remaining * (pendingDuration_ / static_cast<float>(pendingDurations_.size()));
+			return remainingDuration / (1000.0f * jobs_);
+		}
+		else if (finished_ > 0)
+			return elapsedSeconds() * remaining / finished_;
+	}
+	else if (percent_ > 0)
+		return elapsedSeconds() * (100 - percent_) / percent_;
+
+	return -1.0f;
+}
+
+void BuildProgress::printStatus()
+{
+	const int MaxLength = 512;
+	char buffer[MaxLength];
+	char eta[32];
+	formatDuration(remainingSeconds(), eta, sizeof(eta));
+
+	int length = 0;
+	if (total_ > 0)
+		length = snprintf(buffer, MaxLength, "[%3u%%] %u/%u, %u running, ETA %s  %s", percent_, finished_, total_, running_, eta, description_.data());
+	else
+		length = snprintf(buffer, MaxLength, "[%3u%%] ETA %s  %s", percent_, eta, description_.data());
+
+	unsigned int statusLength = (length > 0) ? static_cast<unsigned int>(length) : 0;
+	if (statusLength > MaxStatusLength)
+		statusLength = MaxStatusLength;
+	buffer[statusLength] = '\0';
+
+	std::cout << "\r" << buffer;
+	// Overwrite the remaining characters of a longer previous status
+	if (statusLength_ > statusLength)
+		std::cout << std::string(statusLength_ - statusLength, ' ');
+	std::cout << std::flush;
+	statusLength_ = statusLength;
+}
+
+void BuildProgress::clearStatus()
+{
+	if (statusLength_ > 0)
+	{
+		std::cout << "\r" << std::string(statusLength_, ' ') << "\r" << std::flush;
+		statusLength_ = 0;
+	}
+}
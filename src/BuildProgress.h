@@ -0,0 +1,48 @@
+#pragma once
+
+#include <string>
+#include <chrono>
+#include <unordered_map>
+
+class NinjaLog;
+
+/// A single status line that replaces the progress lines of Ninja and Make
+class BuildProgress
+{
+  public:
+	/// The status format that Ninja uses when the compact progress is enabled
+	static const char *ninjaStatus() { return "[%f/%t %r] "; }
+	/// Returns true if the standard output is a terminal that can update a status line
+	static bool isSupported();
+
+	/// Starts a new build, estimating the remaining time with the durations of the previous runs
+	void begin(const NinjaLog &ninjaLog, unsigned int jobs);
+	/// Updates the status line or prints in full any line that does not report progress
+	void processLine(const char *line);
+	void end();
+
+  private:
+	std::chrono::steady_clock::time_point startTime_;
+	/// Mean duration of a build step in the previous runs, in milliseconds
+	float meanDuration_ = 0.0f;
+	/// The recorded durations of the steps that did not finish yet in this run, by output
+	std::unordered_map<std::string, unsigned int> pendingDurations_;
+	/// Sum of the pending durations, in milliseconds
+	unsigned long int pendingDuration_ = 0;
+	unsigned int jobs_ = 1;
+
+	unsigned int finished_ = 0;
+	unsigned int total_ = 0;
+	unsigned int running_ = 0;
+	unsigned int percent_ = 0;
+	std::string description_;
+	/// Length of the status line currently shown, zero if there is none
+	unsigned int statusLength_ = 0;
+
+	/// Removes the output named at the end of the description of a finished step from the pending ones
+	void finishStep(const std::string &description);
+	float elapsedSeconds() const;
+	float remainingSeconds() const;
+	void printStatus();
+	void clearStatus();
+};
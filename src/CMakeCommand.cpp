@@ -1,6 +1,7 @@
 #include <cassert>
 #include <thread>
 #include "CMakeCommand.h"
+#include "BuildProgress.h"
 #include "Process.h"
 #include "FileSystem.h"
 #include "Configuration.h"
@@ -9,7 +10,7 @@
 namespace {
 
 const int MaxLength = 1024;
-char buffer[MaxLength];
+thread_local char buffer[MaxLength];
 
 #ifdef _WIN32
 const char *vsVersionToGeneratorString(int version)
@@ -67,12 +68,14 @@ bool checkDoxygenPredefinedLocations(std::string &executable)
 
 }
 
+CMakeCommand::Availability CMakeCommand::ninjaMultiConfigAvailable_ = CMakeCommand::Availability::UNKNOWN;
+
 ///////////////////////////////////////////////////////////
 // CONSTRUCTORS and DESTRUCTOR
 ///////////////////////////////////////////////////////////
 
 CMakeCommand::CMakeCommand()
-    : found_(false), ninjaFound_(false)
+    : found_(false), ninjaFound_(false), linkerFound_(false), captureOutput_(false), jobs_(std::thread::hardware_concurrency()), progress_(nullptr)
 {
 	output_.reserve(1024);
 
@@ -85,6 +88,14 @@ CMakeCommand::CMakeCommand()
 	if (executable_.find(' ') != std::string::npos)
 		executable_ = "\"" + executable_ + "\"";
 
+	// CTest is always installed in the same directory as CMake
+	ctestExecutable_ = executable_;
+	const size_t cmakeName = ctestExecutable_.rfind("cmake");
+	if (cmakeName != std::string::npos)
+		ctestExecutable_.replace(cmakeName, 5, "ctest");
+	else
+		ctestExecutable_ = "ctest";
+
 	snprintf(buffer, MaxLength, "%s --version", executable_.data());
 	const bool executed = Process::executeCommand(buffer, output_, Process::Echo::DISABLED, Process::OverrideDryRun::ENABLED);
 	if (executed)
@@ -95,6 +106,13 @@ CMakeCommand::CMakeCommand()
 			findNinja();
 	}
 
+	// The first probe decides for the whole run, the command line grammar depends on it
+	if (ninjaMultiConfigAvailable_ == Availability::UNKNOWN)
+		ninjaMultiConfigAvailable_ = (found_ && ninjaFound_ && supportsNinjaMultiConfig()) ? Availability::AVAILABLE : Availability::UNAVAILABLE;
+
+	if (config().linker() != Configuration::Linker::DEFAULT)
+		findLinker();
+
 	if (config().emcmakeExecutable(emcmakeExecutable_) == false)
 		emcmakeExecutable_ = "emcmake";
 }
@@ -114,7 +132,34 @@ bool CMakeCommand::generatorIsMultiConfig()
 	else
 		return true;
 #else
+	return generatorIsNinjaMultiConfig();
+#endif
+}
+
+bool CMakeCommand::generatorIsVisualStudio()
+{
+#ifdef _WIN32
+	return generatorIsMultiConfig();
+#else
+	return false;
+#endif
+}
+
+bool CMakeCommand::generatorIsNinjaMultiConfig()
+{
+#ifdef _WIN32
 	return false;
+#else
+	if (config().platform() == Configuration::Platform::EMSCRIPTEN)
+		return false;
+
+	if (config().withNinja() == false || config().withNinjaMultiConfig() == false)
+		return false;
+
+	// The arguments are parsed before any command is created, probe the executables now
+	if (ninjaMultiConfigAvailable_ == Availability::UNKNOWN)
+		CMakeCommand probe;
+	return (ninjaMultiConfigAvailable_ == Availability::AVAILABLE);
 #endif
 }
 
@@ -182,7 +227,15 @@ bool CMakeCommand::configure(const char *srcDir, const char *binDir, const char
 		configureCommand += arguments;
 	}
 
-	const bool executed = Process::executeCommand(configureCommand.data());
+	bool executed = false;
+	if (captureOutput_)
+	{
+		// Warnings and errors are printed with the rest of the output, not interleaved with the other configurations
+		configureCommand += " 2>&1";
+		executed = Process::executeCommand(configureCommand.data(), output_, Process::Echo::COMMAND_ONLY);
+	}
+	else
+		executed = Process::executeCommand(configureCommand.data());
 	return executed;
 }
 
@@ -201,7 +254,11 @@ bool CMakeCommand::build(const char *buildDir, const char *config, const char *t
 	assert(found_);
 	assert(buildDir);
 
-	snprintf(buffer, MaxLength, "%s --build \"%s\" -j %u", executable_.data(), buildDir, std::thread::hardware_concurrency());
+	// Without a number of jobs the parallelism is inherited from the jobserver
+	if (jobs_ > 0)
+		snprintf(buffer, MaxLength, "%s --build \"%s\" -j %u", executable_.data(), buildDir, jobs_);
+	else
+		snprintf(buffer, MaxLength, "%s --build \"%s\"", executable_.data(), buildDir);
 	std::string buildCommand = buffer;
 
 	if (config)
@@ -216,7 +273,63 @@ bool CMakeCommand::build(const char *buildDir, const char *config, const char *t
 		buildCommand += buffer;
 	}
 
-	const bool executed = Process::executeCommand(buildCommand.data());
+	bool executed = false;
+	if (progress_)
+		executed = Process::executeCommand(buildCommand.data(), [this](const char *line) { progress_->processLine(line); });
+	else
+		executed = Process::executeCommand(buildCommand.data());
+	return executed;
+}
+
+bool CMakeCommand::install(const char *buildDir, const char *config, const char *prefix)
+{
+	assert(found_);
+	assert(buildDir);
+	assert(prefix);
+
+	if (config)
+		snprintf(buffer, MaxLength, "%s --install \"%s\" --config %s --prefix \"%s\"", executable_.data(), buildDir, config, prefix);
+	else
+		snprintf(buffer, MaxLength, "%s --install \"%s\" --prefix \"%s\"", executable_.data(), buildDir, prefix);
+
+	const bool executed = Process::executeCommand(buffer);
+	return executed;
+}
+
+bool CMakeCommand::listTests(const char *buildDir, const char *config, std::string &output)
+{
+	assert(found_);
+	assert(buildDir);
+
+	if (config)
+		snprintf(buffer, MaxLength, "%s --test-dir \"%s\" --show-only=json-v1 -C %s", ctestExecutable_.data(), buildDir, config);
+	else
+		snprintf(buffer, MaxLength, "%s --test-dir \"%s\" --show-only=json-v1", ctestExecutable_.data(), buildDir);
+
+	const bool executed = Process::executeCommand(buffer, output, Process::Echo::DISABLED, Process::OverrideDryRun::ENABLED);
+	return executed;
+}
+
+bool CMakeCommand::test(const char *buildDir, const char *config, const char *regex, const std::function<void(const char *)> &lineFunction)
+{
+	assert(found_);
+	assert(buildDir);
+
+	// CTest starts the tests with the highest cost first when running them in parallel
+	snprintf(buffer, MaxLength, "%s --test-dir \"%s\" --output-on-failure -j %u", ctestExecutable_.data(), buildDir, jobs_ > 0 ? jobs_ : 1);
+	std::string testCommand = buffer;
+
+	if (config)
+	{
+		snprintf(buffer, MaxLength, " -C %s", config);
+		testCommand += buffer;
+	}
+
+	// A long list of test names can exceed the size of the buffer
+	if (regex)
+		testCommand += " -R \"" + std::string(regex) + "\"";
+
+	const bool executed = Process::executeCommand(testCommand.data(), lineFunction);
 	return executed;
 }
 
@@ -226,6 +339,44 @@ bool CMakeCommand::isUpdated() const
 	return Helpers::checkMinVersion(version_, 3, 13, 0);
 }
 
+bool CMakeCommand::supportsNinjaMultiConfig() const
+{
+	assert(found_);
+	return Helpers::checkMinVersion(version_, 3, 17, 0);
+}
+
+bool CMakeCommand::supportsJobServer(bool fifo) const
+{
+	// Ninja can be a jobserver client since version 1.13, but only with a FIFO
+	if (ninjaFound_ && config().withNinja())
+		return (fifo && Helpers::checkMinVersion(ninjaVersion_, 1, 13, 0));
+	return true;
+}
+
+bool CMakeCommand::supportsProfiling() const
+{
+	assert(found_);
+	return Helpers::checkMinVersion(version_, 3, 18, 0);
+}
+
+bool CMakeCommand::supportsInstall() const
+{
+	assert(found_);
+	return Helpers::checkMinVersion(version_, 3, 15, 0);
+}
+
+bool CMakeCommand::supportsLinkerType() const
+{
+	assert(found_);
+	return Helpers::checkMinVersion(version_, 3, 29, 0);
+}
+
+bool CMakeCommand::supportsTestDir() const
+{
+	assert(found_);
+	return Helpers::checkMinVersion(version_, 3, 20, 0);
+}
+
 void CMakeCommand::addAndroidNdkDirToPath()
 {
 	std::string androidNdkDir;
@@ -321,7 +472,9 @@ const char *CMakeCommand::generator() const
 	else
 		return vsVersionToGeneratorString(config().vsVersion());
 #else
-	if (ninjaFound_ && config().withNinja())
+	if (generatorIsNinjaMultiConfig())
+		return "Ninja Multi-Config";
+	else if (ninjaFound_ && config().withNinja())
 		return "Ninja";
 	else
 		return "Unix Makefiles";
@@ -380,6 +533,30 @@ void CMakeCommand::findNinja()
 		ninjaFound_ = sscanf(output_.data(), "%u.%u.%u", &ninjaVersion_[0], &ninjaVersion_[1], &ninjaVersion_[2]);
 }
 
+void CMakeCommand::findLinker()
+{
+	// The compiler driver looks for the same executables when passed the `-fuse-ld` flag
+	const char *versionString = nullptr;
+	switch (config().linker())
+	{
+		case Configuration::Linker::LLD:
+			linkerExecutable_ = "ld.lld";
+			versionString = "LLD";
+			break;
+		case Configuration::Linker::MOLD:
+			linkerExecutable_ = "mold";
+			versionString = "mold";
+			break;
+		case Configuration::Linker::DEFAULT:
+			return;
+	}
+
+	snprintf(buffer, MaxLength, "%s --version", linkerExecutable_.data());
+	const bool executed = Process::executeCommand(buffer, output_, Process::Echo::DISABLED, Process::OverrideDryRun::ENABLED);
+	if (executed)
+		linkerFound_ = (output_.find(versionString) != std::string::npos);
+}
+
 std::string CMakeCommand::findNMake()
 {
 	std::string nmakeExcutable;
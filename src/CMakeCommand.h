@@ -1,6 +1,9 @@
 #pragma once
 
 #include <string>
+#include <functional>
+
+class BuildProgress;
 
 class CMakeCommand
 {
@@ -8,7 +11,8 @@ class CMakeCommand
 	CMakeCommand();
 
 	static bool generatorIsMultiConfig();
-	static bool generatorIsVisualStudio() { return generatorIsMultiConfig(); }
+	static bool generatorIsVisualStudio();
+	static bool generatorIsNinjaMultiConfig();
 
 	const char *removeFile();
 	const char *removeDir();
@@ -22,15 +26,38 @@ class CMakeCommand
 	inline bool build(const char *buildDir) { return build(buildDir, nullptr, nullptr); }
 	inline bool buildConfig(const char *buildDir, const char *config) { return build(buildDir, config, nullptr); }
 	inline bool buildTarget(const char *buildDir, const char *target) { return build(buildDir, nullptr, target); }
+	bool install(const char *buildDir, const char *config, const char *prefix);
+
+	/// Retrieves the JSON description of the tests of a build directory, with their commands
+	bool listTests(const char *buildDir, const char *config, std::string &output);
+	/// Runs the tests whose names match a regular expression, or all of them if it is `nullptr`, passing every output line to a function
+	bool test(const char *buildDir, const char *config, const char *regex, const std::function<void(const char *)> &lineFunction);
+
+	inline unsigned int jobs() const { return jobs_; }
+	/// A value of zero does not pass the number of jobs to the build tool
+	inline void setJobs(unsigned int jobs) { jobs_ = jobs; }
 
 	inline bool found() const { return found_; }
 	inline const std::string &executable() const { return executable_; }
+	inline const std::string &ctestExecutable() const { return ctestExecutable_; }
 	bool isUpdated() const;
+	bool supportsNinjaMultiConfig() const;
+	bool supportsProfiling() const;
+	bool supportsInstall() const;
+	bool supportsJobServer(bool fifo) const;
+	bool supportsLinkerType() const;
+	bool supportsTestDir() const;
 
 	inline bool ninjaFound() const { return ninjaFound_; }
 	inline const std::string &ninjaExecutable() const { return ninjaExecutable_; }
+	inline bool linkerFound() const { return linkerFound_; }
+	inline const std::string &linkerExecutable() const { return linkerExecutable_; }
 
 	inline const std::string &output() const { return output_; }
+	/// Captures the output of configure commands instead of echoing it, to run them concurrently
+	inline void setCaptureOutput(bool value) { captureOutput_ = value; }
+	/// Passes the output of build commands to a compact progress line, if not `nullptr`
+	inline void setProgress(BuildProgress *progress) { progress_ = progress; }
 
 	void addAndroidNdkDirToPath();
 	void addNMakeDirToPath();
@@ -39,21 +66,38 @@ class CMakeCommand
 	void addDoxygenDirToPath();
 
   private:
+	enum class Availability
+	{
+		UNKNOWN,
+		AVAILABLE,
+		UNAVAILABLE
+	};
+
+	/// Set by the first constructed command, when Ninja is found and CMake can use its multi-configuration generator
+	static Availability ninjaMultiConfigAvailable_;
+
 	bool found_;
 	std::string executable_;
 	unsigned int version_[3];
+	std::string ctestExecutable_;
 
 	bool ninjaFound_;
 	std::string ninjaExecutable_;
 	unsigned int ninjaVersion_[3];
+	bool linkerFound_;
+	std::string linkerExecutable_;
 	std::string emcmakeExecutable_;
 
 	std::string output_;
+	bool captureOutput_;
+	unsigned int jobs_;
+	BuildProgress *progress_;
 
 	const char *generator() const;
 	const char *platform() const;
 
 	bool checkPredefinedLocations();
 	void findNinja();
+	void findLinker();
 	std::string findNMake();
 };
@@ -0,0 +1,179 @@
+#include <cassert>
+#include <cstdio>
+#include <algorithm>
+#include <iostream>
+#include <map>
+#include "CMakeTrace.h"
+#include "JsonValue.h"
+#include "Helpers.h"
+
+namespace {
+
+struct Event
+{
+	const std::string *name;
+	const std::string *location;
+	double tid;
+	double start;
+	double duration;
+	double childrenTime;
+};
+
+bool eventCompare(const Event &a, const Event &b)
+{
+	if (a.tid != b.tid)
+		return a.tid < b.tid;
+	else if (a.start != b.start)
+		return a.start < b.start;
+	// An enclosing event starting at the same time as its first child comes first
+	return a.duration > b.duration;
+}
+
+/// Returns the script file of a `path/to/CMakeLists.txt:123` location
+std::string locationToFile(const std::string &location)
+{
+	const size_t colon = location.rfind(':');
+	if (colon == std::string::npos || colon == 0)
+		return location;
+	return location.substr(0, colon);
+}
+
+template <class Map>
+void mapToEntries(const Map &map, std::vector<typename Map::mapped_type> &entries)
+{
+	entries.clear();
+	entries.reserve(map.size());
+	for (const auto &pair : map)
+		entries.push_back(pair.second);
+
+	std::sort(entries.begin(), entries.end(), [](const typename Map::mapped_type &a, const typename Map::mapped_type &b) { return a.selfTime > b.selfTime; });
+}
+
+}
+
+///////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////
+
+bool CMakeTrace::load(const char *filename)
+{
+	assert(filename);
+
+	JsonValue root;
+	if (JsonValue::parseFile(filename, root) == false || root.isArray() == false)
+		return false;
+
+	std::vector<Event> events;
+	events.reserve(root.elements().size() / 2);
+	// CMake writes begin and end events, while other tools write complete events with a duration
+	std::map<double, std::vector<unsigned int>> openEvents;
+	for (const JsonValue &element : root.elements())
+	{
+		const std::string &phase = element.stringMember("ph");
+		const double tid = element.numberMember("tid", 0.0);
+
+		if (phase == "E")
+		{
+			std::vector<unsigned int> &open = openEvents[tid];
+			if (open.empty() == false)
+			{
+				Event &event = events[open.back()];
+				event.duration = element.numberMember("ts", 0.0) - event.start;
+				open.pop_back();
+			}
+			continue;
+		}
+		else if (phase != "B" && phase != "X")
+			continue;
+
+		Event event;
+		event.name = &element.stringMember("name");
+		const JsonValue *args = element.member("args");
+		event.location = args ? &args->stringMember("location") : &element.stringMember("location");
+		event.tid = tid;
+		event.start = element.numberMember("ts", 0.0);
+		event.duration = element.numberMember("dur", 0.0);
+		event.childrenTime = 0.0;
+
+		if (phase == "B")
+			openEvents[tid].push_back(events.size());
+		events.push_back(event);
+	}
+	std::sort(events.begin(), events.end(), eventCompare);
+
+	// Durations are inclusive of nested commands, the self time is computed with a stack of open events
+	std::vector<Event *> stack;
+	double lastTid = -1.0;
+	double firstStart = events.empty() ? 0.0 : events.front().start;
+	double lastEnd = firstStart;
+	for (Event &event : events)
+	{
+		if (event.tid != lastTid)
+		{
+			stack.clear();
+			lastTid = event.tid;
+		}
+
+		while (stack.empty() == false && stack.back()->start + stack.back()->duration <= event.start)
+			stack.pop_back();
+		if (stack.empty() == false)
+			stack.back()->childrenTime += event.duration;
+		stack.push_back(&event);
+
+		firstStart = std::min(firstStart, event.start);
+		lastEnd = std::max(lastEnd, event.start + event.duration);
+	}
+	totalTime_ = lastEnd - firstStart;
+
+	std::map<std::string, Entry> commands;
+	std::map<std::string, Entry> files;
+	for (const Event &event : events)
+	{
+		const double selfTime = std::max(event.duration - event.childrenTime, 0.0);
+
+		Entry &command = commands[*event.name];
+		command.name = *event.name;
+		command.selfTime += selfTime;
+		command.count++;
+
+		if (event.location->empty() == false)
+		{
+			const std::string file = locationToFile(*event.location);
+			Entry &fileEntry = files[file];
+			fileEntry.name = file;
+			fileEntry.selfTime += selfTime;
+			fileEntry.count++;
+		}
+	}
+
+	mapToEntries(commands, commands_);
+	mapToEntries(files, files_);
+
+	return true;
+}
+
+void CMakeTrace::printReport(unsigned int numEntries) const
+{
+	const int MaxLength = 512;
+	char buffer[MaxLength];
+
+	snprintf(buffer, MaxLength, "%.2f s", totalTime_ / 1000000.0);
+	Helpers::info("Total profiled configuration time: ", buffer);
+
+	Helpers::info("Slowest commands by self time:");
+	for (unsigned int i = 0; i < commands_.size() && i < numEntries; i++)
+	{
+		const Entry &entry = commands_[i];
+		snprintf(buffer, MaxLength, "%10.1f ms %8u calls  %s", entry.selfTime / 1000.0, entry.count, entry.name.data());
+		std::cout << buffer << "\n";
+	}
+
+	Helpers::info("Slowest files and modules by self time:");
+	for (unsigned int i = 0; i < files_.size() && i < numEntries; i++)
+	{
+		const Entry &entry = files_[i];
+		snprintf(buffer, MaxLength, "%10.1f ms %8u calls  %s", entry.selfTime / 1000.0, entry.count, entry.name.data());
+		std::cout << buffer << "\n";
+	}
+	std::cout << std::flush;
+}
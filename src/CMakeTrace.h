@@ -0,0 +1,27 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+/// The analysis of a CMake configuration profiled in the Google Trace format
+class CMakeTrace
+{
+  public:
+	bool load(const char *filename);
+	void printReport(unsigned int numEntries) const;
+
+  private:
+	struct Entry
+	{
+		std::string name;
+		double selfTime = 0.0;
+		unsigned int count = 0;
+	};
+
+	/// Total time spent by CMake, in microseconds
+	double totalTime_ = 0.0;
+	/// Self time aggregated by command name
+	std::vector<Entry> commands_;
+	/// Self time aggregated by script file
+	std::vector<Entry> files_;
+};
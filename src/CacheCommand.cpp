@@ -0,0 +1,170 @@
+#include <cassert>
+#include <cstring>
+#include "CacheCommand.h"
+#include "Process.h"
+#include "FileSystem.h"
+#include "Configuration.h"
+#include "Helpers.h"
+
+namespace {
+
+const int MaxLength = 1024;
+char buffer[MaxLength];
+
+const char *DefaultCacheDir = "compiler-cache";
+const char *DefaultCacheSize = "5G";
+
+/// Returns the value of a counter from the machine-parsable output of `ccache --print-stats`
+unsigned int ccacheCounter(const std::string &output, const char *name)
+{
+	const size_t nameLength = strlen(name);
+	size_t pos = 0;
+	while (pos < output.length())
+	{
+		const size_t lineEnd = output.find('\n', pos);
+		if (output.compare(pos, nameLength, name) == 0 && output[pos + nameLength] == '\t')
+			return strtoul(output.data() + pos + nameLength + 1, nullptr, 10);
+
+		if (lineEnd == std::string::npos)
+			break;
+		pos = lineEnd + 1;
+	}
+
+	return 0;
+}
+
+/// Returns the value of a counter from the human-readable output of `sccache --show-stats`
+unsigned int sccacheCounter(const std::string &output, const char *label)
+{
+	const size_t labelLength = strlen(label);
+	size_t pos = 0;
+	while (pos < output.length())
+	{
+		const size_t lineEnd = output.find('\n', pos);
+		if (output.compare(pos, labelLength, label) == 0 && output[pos + labelLength] == ' ')
+			return strtoul(output.data() + pos + labelLength, nullptr, 10);
+
+		if (lineEnd == std::string::npos)
+			break;
+		pos = lineEnd + 1;
+	}
+
+	return 0;
+}
+
+}
+
+///////////////////////////////////////////////////////////
+// CONSTRUCTORS and DESTRUCTOR
+///////////////////////////////////////////////////////////
+
+CacheCommand::CacheCommand()
+    : enabled_(false), found_(false)
+{
+	switch (config().compilerCache())
+	{
+		case Configuration::CompilerCache::CCACHE:
+			executable_ = "ccache";
+			break;
+		case Configuration::CompilerCache::SCCACHE:
+			executable_ = "sccache";
+			break;
+		case Configuration::CompilerCache::NONE:
+			return;
+	}
+	enabled_ = true;
+	output_.reserve(1024);
+
+	snprintf(buffer, MaxLength, "%s --version", executable_.data());
+	const bool executed = Process::executeCommand(buffer, output_, Process::Echo::DISABLED, Process::OverrideDryRun::ENABLED);
+	if (executed)
+	{
+		if (config().compilerCache() == Configuration::CompilerCache::CCACHE)
+			found_ = (sscanf(output_.data(), "ccache version %u.%u.%u", &version_[0], &version_[1], &version_[2]) == 3);
+		else
+			found_ = (sscanf(output_.data(), "sccache %u.%u.%u", &version_[0], &version_[1], &version_[2]) == 3);
+	}
+}
+
+///////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////
+
+bool CacheCommand::setupEnvironment()
+{
+	if (found_ == false)
+		return false;
+
+	// The cache is shared by all the projects in the working directory
+	std::string cacheDir;
+	if (config().compilerCacheDir(cacheDir) == false || cacheDir.empty())
+		cacheDir = fs::joinPath(fs::currentDir(), DefaultCacheDir);
+
+	std::string cacheSize;
+	if (config().compilerCacheSize(cacheSize) == false || cacheSize.empty())
+		cacheSize = DefaultCacheSize;
+
+	if (config().compilerCache() == Configuration::CompilerCache::CCACHE)
+	{
+		Helpers::info("Set the CCACHE_DIR environment variable to: ", cacheDir.data());
+		Helpers::setEnvironment("CCACHE_DIR", cacheDir.data());
+		Helpers::setEnvironment("CCACHE_MAXSIZE", cacheSize.data());
+		// Relative paths let different checkouts of the same sources share cache entries
+		Helpers::setEnvironment("CCACHE_BASEDIR", fs::currentDir().data());
+	}
+	else
+	{
+		Helpers::info("Set the SCCACHE_DIR environment variable to: ", cacheDir.data());
+		Helpers::setEnvironment("SCCACHE_DIR", cacheDir.data());
+		Helpers::setEnvironment("SCCACHE_CACHE_SIZE", cacheSize.data());
+	}
+
+	return true;
+}
+
+bool CacheCommand::retrieveStats(unsigned int &hits, unsigned int &misses)
+{
+	if (found_ == false || Process::dryRun)
+		return false;
+
+	if (config().compilerCache() == Configuration::CompilerCache::CCACHE)
+		return retrieveCcacheStats(hits, misses);
+	else
+		return retrieveSccacheStats(hits, misses);
+}
+
+///////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+///////////////////////////////////////////////////////////
+
+bool CacheCommand::retrieveCcacheStats(unsigned int &hits, unsigned int &misses)
+{
+	assert(found_);
+
+	snprintf(buffer, MaxLength, "%s --print-stats", executable_.data());
+	const bool executed = Process::executeCommand(buffer, output_, Process::Echo::DISABLED);
+	if (executed == false)
+		return false;
+
+	// Counter names changed with ccache 4.x
+	hits = ccacheCounter(output_, "direct_cache_hit") + ccacheCounter(output_, "preprocessed_cache_hit") +
+	       ccacheCounter(output_, "cache_hit_direct") + ccacheCounter(output_, "cache_hit_preprocessed");
+	misses = ccacheCounter(output_, "cache_miss");
+
+	return true;
+}
+
+bool CacheCommand::retrieveSccacheStats(unsigned int &hits, unsigned int &misses)
+{
+	assert(found_);
+
+	snprintf(buffer, MaxLength, "%s --show-stats", executable_.data());
+	const bool executed = Process::executeCommand(buffer, output_, Process::Echo::DISABLED);
+	if (executed == false)
+		return false;
+
+	hits = sccacheCounter(output_, "Cache hits");
+	misses = sccacheCounter(output_, "Cache misses");
+
+	return true;
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <string>
+
+/// The compiler cache (ccache or sccache) used as a compiler launcher
+class CacheCommand
+{
+  public:
+	CacheCommand();
+
+	bool setupEnvironment();
+	bool retrieveStats(unsigned int &hits, unsigned int &misses);
+
+	inline bool enabled() const { return enabled_; }
+	inline bool found() const { return found_; }
+	inline const std::string &executable() const { return executable_; }
+	inline const std::string &output() const { return output_; }
+
+  private:
+	bool enabled_;
+	bool found_;
+	std::string executable_;
+	unsigned int version_[3];
+
+	std::string output_;
+
+	bool retrieveCcacheStats(unsigned int &hits, unsigned int &misses);
+	bool retrieveSccacheStats(unsigned int &hits, unsigned int &misses);
+};
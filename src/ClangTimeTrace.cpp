@@ -0,0 +1,127 @@
+#include <cassert>
+#include <cstdio>
+#include <algorithm>
+#include <iostream>
+#include "ClangTimeTrace.h"
+#include "JsonValue.h"
+#include "Helpers.h"
+
+namespace {
+
+/// Returns the name of a template without its arguments, to group all its instantiations
+std::string templateSetName(const std::string &name)
+{
+	const size_t angle = name.find('<');
+	return (angle == std::string::npos) ? name : name.substr(0, angle) + "<$>";
+}
+
+template <class Entry>
+void addTime(std::map<std::string, Entry> &map, const std::string &name, double time)
+{
+	Entry &entry = map[name];
+	if (entry.count == 0)
+		entry.name = name;
+	entry.time += time;
+	entry.count++;
+}
+
+void printEntry(const char *name, double time, unsigned int count)
+{
+	const int MaxLength = 1024;
+	char buffer[MaxLength];
+	snprintf(buffer, MaxLength, "%10.1f ms %8u times  %s", time / 1000.0, count, name);
+	std::cout << buffer << "\n";
+}
+
+}
+
+///////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////
+
+bool ClangTimeTrace::add(const char *filename)
+{
+	assert(filename);
+
+	JsonValue root;
+	if (JsonValue::parseFile(filename, root) == false)
+		return false;
+
+	const JsonValue *events = root.member("traceEvents");
+	if (events == nullptr || events->isArray() == false)
+		return false;
+
+	Entry unit;
+	unit.name = filename;
+	unit.count = 1;
+	for (const JsonValue &event : events->elements())
+	{
+		if (event.stringMember("ph") != "X")
+			continue;
+
+		const std::string &name = event.stringMember("name");
+		const double duration = event.numberMember("dur", 0.0);
+		const JsonValue *args = event.member("args");
+		const std::string &detail = args ? args->stringMember("detail") : event.stringMember("detail");
+
+		// Nested events are included in the time of the enclosing ones, like ClangBuildAnalyzer does
+		if (name == "Source")
+			addTime(headers_, detail, duration);
+		else if (name == "InstantiateClass" || name == "InstantiateFunction")
+		{
+			addTime(templates_, detail, duration);
+			addTime(templateSets_, templateSetName(detail), duration);
+		}
+		else if (name == "CodeGen Function" || name == "OptFunction")
+			addTime(functions_, detail, duration);
+		else if (name == "Frontend")
+			frontendTime_ += duration;
+		else if (name == "Backend")
+			backendTime_ += duration;
+		else if (name == "ExecuteCompiler")
+			unit.time += duration;
+	}
+
+	units_.push_back(unit);
+	numUnits_++;
+	return true;
+}
+
+void ClangTimeTrace::printReport(unsigned int numEntries) const
+{
+	const int MaxLength = 256;
+	char buffer[MaxLength];
+	snprintf(buffer, MaxLength, "%u translation units, %.2f s frontend, %.2f s backend", numUnits_, frontendTime_ / 1000000.0, backendTime_ / 1000000.0);
+	Helpers::info("Compilation time: ", buffer);
+
+	std::vector<Entry> units(units_);
+	std::sort(units.begin(), units.end(), [](const Entry &a, const Entry &b) { return a.time > b.time; });
+	Helpers::info("Slowest translation units:");
+	for (unsigned int i = 0; i < units.size() && i < numEntries; i++)
+		printEntry(units[i].name.data(), units[i].time, units[i].count);
+
+	printEntries("Most expensive headers by total parse time:", headers_, numEntries);
+	printEntries("Most expensive template instantiations:", templates_, numEntries);
+	printEntries("Most expensive template sets:", templateSets_, numEntries);
+	printEntries("Slowest functions to generate code for:", functions_, numEntries);
+	std::cout << std::flush;
+}
+
+///////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+///////////////////////////////////////////////////////////
+
+void ClangTimeTrace::printEntries(const char *title, const std::map<std::string, Entry> &map, unsigned int numEntries) const
+{
+	std::vector<const Entry *> entries;
+	entries.reserve(map.size());
+	for (const auto &pair : map)
+		entries.push_back(&pair.second);
+
+	const unsigned int numSorted = std::min(numEntries, static_cast<unsigned int>(entries.size()));
+	std::partial_sort(entries.begin(), entries.begin() + numSorted, entries.end(), [](const Entry *a, const Entry *b) { return a->time > b->time; });
+
+	Helpers::info(title);
+	for (unsigned int i = 0; i < numSorted; i++)
+		printEntry(entries[i]->name.data(), entries[i]->time, entries[i]->count);
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+
+/// The aggregation of the `-ftime-trace` reports of many translation units compiled by Clang
+class ClangTimeTrace
+{
+  public:
+	/// Adds the events of the report of a translation unit, returns false if it is not a Clang time trace
+	bool add(const char *filename);
+	void printReport(unsigned int numEntries) const;
+
+	inline unsigned int numUnits() const { return numUnits_; }
+
+  private:
+	struct Entry
+	{
+		std::string name;
+		double time = 0.0;
+		unsigned int count = 0;
+	};
+
+	unsigned int numUnits_ = 0;
+	/// Total times in microseconds
+	double frontendTime_ = 0.0;
+	double backendTime_ = 0.0;
+
+	std::vector<Entry> units_;
+	std::map<std::string, Entry> headers_;
+	std::map<std::string, Entry> templates_;
+	std::map<std::string, Entry> templateSets_;
+	std::map<std::string, Entry> functions_;
+
+	void printEntries(const char *title, const std::map<std::string, Entry> &map, unsigned int numEntries) const;
+};
@@ -1,23 +1,21 @@
 #include <cassert>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <vector>
 #include "ConfMode.h"
 #include "CMakeCommand.h"
+#include "CacheCommand.h"
+#include "CMakeTrace.h"
+#include "Trash.h"
 #include "FileSystem.h"
 #include "Settings.h"
 #include "Configuration.h"
+#include "Process.h"
 #include "Helpers.h"
 
 namespace {
 
-const char *settingsToBuildTypeString(Settings::BuildType buildType)
-{
-	switch (buildType)
-	{
-		case Settings::BuildType::DEBUG: return "Debug";
-		case Settings::BuildType::RELEASE: return "Release";
-	}
-	return nullptr;
-}
-
 bool preferredCompilerArgs(std::string &cmakeArguments)
 {
 	if (config().platform() == Configuration::Platform::EMSCRIPTEN)
@@ -49,7 +47,178 @@ bool buildTypeArg(std::string &cmakeArguments, const Settings &settings)
 	if (CMakeCommand::generatorIsMultiConfig() == false || config().platform() == Configuration::Platform::ANDROID)
 	{
 		cmakeArguments += " -D CMAKE_BUILD_TYPE=";
-		cmakeArguments += settingsToBuildTypeString(settings.buildType());
+		cmakeArguments += Settings::buildTypeToConfigString(settings.buildType());
+		argumentsAdded = true;
+	}
+
+	return argumentsAdded;
+}
+
+bool configurationTypesArg(std::string &cmakeArguments)
+{
+	// Visual Studio generators already define all four configurations
+	if (CMakeCommand::generatorIsNinjaMultiConfig() == false)
+		return false;
+
+	cmakeArguments += " -D CMAKE_CONFIGURATION_TYPES=\"Debug;Release;RelWithDebInfo;MinSizeRel\"";
+	return true;
+}
+
+void appendFlag(std::string &flags, const char *flag)
+{
+	if (flag[0] == '\0')
+		return;
+
+	if (flags.empty() == false)
+		flags += " ";
+	flags += flag;
+}
+
+bool hasDebugInfo(const Settings &settings)
+{
+	// Multi-configuration generators choose the build type at build time
+	if (CMakeCommand::generatorIsMultiConfig())
+		return true;
+
+	return (settings.buildType() == Settings::BuildType::DEBUG || settings.buildType() == Settings::BuildType::RELWITHDEBINFO ||
+	        settings.buildType() == Settings::BuildType::PROFILE);
+}
+
+/// Split DWARF and compressed debug sections are only supported for ELF files
+bool withDebugInfoFlags(const Settings &settings)
+{
+#if defined(_WIN32) || defined(__APPLE__)
+	return false;
+#else
+	return (config().platform() == Configuration::Platform::DESKTOP && hasDebugInfo(settings));
+#endif
+}
+
+bool withLinker(const CMakeCommand &cmake)
+{
+	return (cmake.linkerFound() && config().platform() == Configuration::Platform::DESKTOP && CMakeCommand::generatorIsVisualStudio() == false);
+}
+
+/// Both LLD and mold can write the index that lets GDB load the debug information faster, the default GNU linker cannot
+bool withGdbIndex(const CMakeCommand &cmake, const Settings &settings)
+{
+	return (withLinker(cmake) && withDebugInfoFlags(settings));
+}
+
+/// Link-time optimization is only applied to the release builds of the engine and of the game
+bool withLto(const Settings &settings)
+{
+	if (config().lto() == Configuration::Lto::OFF || settings.target() == Settings::Target::LIBS)
+		return false;
+	else if (CMakeCommand::generatorIsVisualStudio() && config().platform() != Configuration::Platform::ANDROID)
+		return false;
+
+	// The flags would also apply to the other configurations of a multi-configuration generator
+	const bool singleConfig = (CMakeCommand::generatorIsMultiConfig() == false || config().platform() == Configuration::Platform::ANDROID);
+	return (singleConfig && settings.buildType() == Settings::BuildType::RELEASE);
+}
+
+bool compilerFlagsArgs(std::string &cmakeArguments, const CMakeCommand &cmake, const Settings &settings, const std::string &extraFlags)
+{
+	// Frame pointers are not omitted on x64 by MSVC and debug information is already part of the `RelWithDebInfo` configuration
+	if (CMakeCommand::generatorIsVisualStudio() && config().platform() != Configuration::Platform::ANDROID)
+		return false;
+
+	std::string flags;
+	if (settings.buildType() == Settings::BuildType::PROFILE)
+		appendFlag(flags, "-fno-omit-frame-pointer");
+
+	if (withDebugInfoFlags(settings))
+	{
+		if (config().withSplitDwarf())
+			appendFlag(flags, "-gsplit-dwarf");
+		if (config().withCompressedDebug())
+			appendFlag(flags, "-gz");
+		// The linker builds the GDB index from the public names sections
+		if (withGdbIndex(cmake, settings))
+			appendFlag(flags, "-ggnu-pubnames");
+	}
+
+	if (withLto(settings))
+	{
+		std::string linkFlags;
+		ConfMode::ltoFlags(flags, linkFlags, cmake, true);
+	}
+	appendFlag(flags, extraFlags.data());
+
+	if (flags.empty())
+		return false;
+
+	cmakeArguments += " -D CMAKE_C_FLAGS=\"" + ConfMode::withEnvironmentFlags("CFLAGS", flags) + "\"";
+	cmakeArguments += " -D CMAKE_CXX_FLAGS=\"" + ConfMode::withEnvironmentFlags("CXXFLAGS", flags) + "\"";
+
+	return true;
+}
+
+bool linkerArgs(std::string &cmakeArguments, const CMakeCommand &cmake, const Settings &settings, const std::string &extraFlags)
+{
+	bool argumentsAdded = false;
+	std::string flags;
+
+	if (withLinker(cmake))
+	{
+		const bool isLLD = (config().linker() == Configuration::Linker::LLD);
+		if (cmake.supportsLinkerType())
+		{
+			cmakeArguments += isLLD ? " -D CMAKE_LINKER_TYPE=LLD" : " -D CMAKE_LINKER_TYPE=MOLD";
+			argumentsAdded = true;
+		}
+		else
+			appendFlag(flags, isLLD ? "-fuse-ld=lld" : "-fuse-ld=mold");
+	}
+
+	if (withDebugInfoFlags(settings))
+	{
+		if (config().withCompressedDebug())
+			appendFlag(flags, "-gz");
+		if (withGdbIndex(cmake, settings))
+			appendFlag(flags, "-Wl,--gdb-index");
+	}
+
+	if (withLto(settings))
+	{
+		std::string compileFlags;
+		ConfMode::ltoFlags(compileFlags, flags, cmake, true);
+	}
+	appendFlag(flags, extraFlags.data());
+
+	if (flags.empty() == false)
+	{
+		flags = ConfMode::withEnvironmentFlags("LDFLAGS", flags);
+		cmakeArguments += " -D CMAKE_EXE_LINKER_FLAGS=\"" + flags + "\"";
+		cmakeArguments += " -D CMAKE_SHARED_LINKER_FLAGS=\"" + flags + "\"";
+		cmakeArguments += " -D CMAKE_MODULE_LINKER_FLAGS=\"" + flags + "\"";
+		argumentsAdded = true;
+	}
+
+	return argumentsAdded;
+}
+
+/// Nothing is passed until a setting is chosen, then both values are passed explicitly as CMake keeps them in its cache
+bool unityBuildArgs(std::string &cmakeArguments)
+{
+	bool argumentsAdded = false;
+
+	if (config().hasUnityBuild())
+	{
+		const int MaxLength = 128;
+		char buffer[MaxLength];
+		if (config().withUnityBuild())
+			snprintf(buffer, MaxLength, " -D CMAKE_UNITY_BUILD=ON -D CMAKE_UNITY_BUILD_BATCH_SIZE=%u", config().unityBatchSize());
+		else
+			snprintf(buffer, MaxLength, " -D CMAKE_UNITY_BUILD=OFF");
+		cmakeArguments += buffer;
+		argumentsAdded = true;
+	}
+
+	if (config().hasPrecompiledHeaders())
+	{
+		cmakeArguments += config().withPrecompiledHeaders() ? " -D CMAKE_DISABLE_PRECOMPILE_HEADERS=OFF" : " -D CMAKE_DISABLE_PRECOMPILE_HEADERS=ON";
 		argumentsAdded = true;
 	}
 
@@ -146,129 +315,327 @@ bool ncineDirArg(std::string &cmakeArguments)
 	return argumentsAdded;
 }
 
+std::string traceFile(const std::string &buildDir)
+{
+	// The trace is kept next to the build directory, so that cleaning it does not remove the trace
+	return buildDir + ".cmake-trace.json";
+}
+
+bool profilingArgs(std::string &cmakeArguments, const CMakeCommand &cmake, const Settings &settings, const std::string &buildDir)
+{
+	if (settings.profileConfiguration() == false || cmake.supportsProfiling() == false)
+		return false;
+
+	cmakeArguments += " --profiling-format=google-trace --profiling-output=\"" + traceFile(buildDir) + "\"";
+	return true;
+}
+
 bool cleanBuildDir(CMakeCommand &cmake, const Settings &settings, const std::string &buildDir)
 {
 	if (settings.clean() && fs::isDirectory(buildDir.data()))
 	{
 		Helpers::info("Remove the build directory: ", buildDir.data());
-		std::string cleanCommand = cmake.removeDir() + buildDir;
-		bool executed = cmake.toolsMode(cleanCommand.data());
-
-		return executed;
+		return Trash::removeDir(cmake, buildDir);
 	}
 
 	return false;
 }
 
-void configureAndroidLibraries(CMakeCommand &cmake, const Settings &settings)
+void setupEnvironment(CMakeCommand &cmake, const Settings &settings)
 {
-	cmake.addAndroidNdkDirToPath();
+	if (config().platform() == Configuration::Platform::ANDROID)
+	{
+		cmake.addAndroidNdkDirToPath();
+		if (settings.target() == Settings::Target::GAME)
+			cmake.addGradleDirToPath();
+	}
+}
 
+bool configureAndroidLibraries(CMakeCommand &cmake, const CacheCommand &cache, const Settings &settings)
+{
 	Helpers::info("Configure the Android libraries");
 
 	std::string buildDir = Helpers::nCineAndroidLibrariesSourceDir();
-	Helpers::buildDir(buildDir);
+	Helpers::buildDir(buildDir, settings);
 	cleanBuildDir(cmake, settings, buildDir);
 
 	std::string arguments;
 	androidArchArg(arguments);
 	buildTypeArg(arguments, settings);
+	ConfMode::compilerLauncherArgs(arguments, cache);
+	profilingArgs(arguments, cmake, settings, buildDir);
 
 #ifdef _WIN32
-	cmake.configure(Helpers::nCineAndroidLibrariesSourceDir(), buildDir.data(), "NMake Makefiles", nullptr, arguments.empty() ? nullptr : arguments.data());
+	return cmake.configure(Helpers::nCineAndroidLibrariesSourceDir(), buildDir.data(), "NMake Makefiles", nullptr, arguments.empty() ? nullptr : arguments.data());
 #else
-	cmake.configure(Helpers::nCineAndroidLibrariesSourceDir(), buildDir.data(), arguments.empty() ? nullptr : arguments.data());
+	return cmake.configure(Helpers::nCineAndroidLibrariesSourceDir(), buildDir.data(), arguments.empty() ? nullptr : arguments.data());
 #endif
 }
 
-void configureLibraries(CMakeCommand &cmake, const Settings &settings)
+bool configureLibraries(CMakeCommand &cmake, const CacheCommand &cache, const Settings &settings)
 {
 	Helpers::info("Configure the libraries");
 
 	std::string buildDir = Helpers::nCineLibrariesSourceDir();
-	Helpers::buildDir(buildDir);
+	Helpers::buildDir(buildDir, settings);
 	cleanBuildDir(cmake, settings, buildDir);
 
 	std::string arguments;
 	preferredCompilerArgs(arguments);
+	ConfMode::compilerLauncherArgs(arguments, cache);
 	buildTypeArg(arguments, settings);
+	configurationTypesArg(arguments);
+	compilerFlagsArgs(arguments, cmake, settings, std::string());
+	profilingArgs(arguments, cmake, settings, buildDir);
 
-	cmake.configure(Helpers::nCineLibrariesSourceDir(), buildDir.data(), arguments.empty() ? nullptr : arguments.data());
+	return cmake.configure(Helpers::nCineLibrariesSourceDir(), buildDir.data(), arguments.empty() ? nullptr : arguments.data());
 }
 
-void configureEngine(CMakeCommand &cmake, const Settings &settings)
+bool configureEngine(CMakeCommand &cmake, const CacheCommand &cache, const Settings &settings)
 {
-	if (config().platform() == Configuration::Platform::ANDROID)
-		cmake.addAndroidNdkDirToPath();
-
 	Helpers::info("Configure the engine");
 
 	std::string buildDir = Helpers::nCineSourceDir();
-	Helpers::buildDir(buildDir);
+	Helpers::buildDir(buildDir, settings);
 	cleanBuildDir(cmake, settings, buildDir);
 
 	std::string arguments;
-	preferredCompilerArgs(arguments);
-	buildTypeArg(arguments, settings);
-	engineAndroidArg(arguments);
-	prefixPathArg(arguments);
-	additionalEngineArgs(arguments);
+	ConfMode::engineArguments(arguments, cmake, cache, settings);
+	profilingArgs(arguments, cmake, settings, buildDir);
 
-	cmake.configure(Helpers::nCineSourceDir(), buildDir.data(), arguments.empty() ? nullptr : arguments.data());
+	return cmake.configure(Helpers::nCineSourceDir(), buildDir.data(), arguments.empty() ? nullptr : arguments.data());
 }
 
-void configureGame(CMakeCommand &cmake, const Settings &settings, const std::string &gameName)
+bool configureGame(CMakeCommand &cmake, const CacheCommand &cache, const Settings &settings, const std::string &gameName)
 {
-	if (config().platform() == Configuration::Platform::ANDROID)
-	{
-		cmake.addAndroidNdkDirToPath();
-		cmake.addGradleDirToPath();
-	}
-
 	Helpers::info("Configure the game: ", gameName.data());
 
 	std::string buildDir = gameName;
-	Helpers::buildDir(buildDir);
+	Helpers::buildDir(buildDir, settings);
 	cleanBuildDir(cmake, settings, buildDir);
 
 	std::string arguments;
-	preferredCompilerArgs(arguments);
-	buildTypeArg(arguments, settings);
-	gameAndroidArg(arguments);
-	ncineDirArg(arguments);
-	additionalGameArgs(arguments);
+	ConfMode::gameArguments(arguments, cmake, cache, settings);
+	profilingArgs(arguments, cmake, settings, buildDir);
 
-	cmake.configure(gameName.data(), buildDir.data(), arguments.empty() ? nullptr : arguments.data());
+	return cmake.configure(gameName.data(), buildDir.data(), arguments.empty() ? nullptr : arguments.data());
 }
 
-}
+void printProfilingReport(const Settings &settings)
+{
+	if (Process::dryRun)
+		return;
 
-///////////////////////////////////////////////////////////
-// PUBLIC FUNCTIONS
-///////////////////////////////////////////////////////////
+	const std::string filename = traceFile(Helpers::targetBuildDir(settings));
+	CMakeTrace trace;
+	if (trace.load(filename.data()))
+	{
+		Helpers::info("Configuration profile saved to: ", filename.data());
+		trace.printReport(settings.profileEntries());
+	}
+	else
+		Helpers::error("Cannot read the configuration profile: ", filename.data());
+}
 
-void ConfMode::perform(CMakeCommand &cmake, const Settings &settings)
+bool configureTarget(CMakeCommand &cmake, const CacheCommand &cache, const Settings &settings)
 {
-	assert(settings.mode() == Settings::Mode::CONF);
+	bool configured = false;
 
 	switch (settings.target())
 	{
 		case Settings::Target::LIBS:
 			if (config().platform() == Configuration::Platform::ANDROID)
-				configureAndroidLibraries(cmake, settings);
+				configured = configureAndroidLibraries(cmake, cache, settings);
 			else
-				configureLibraries(cmake, settings);
+				configured = configureLibraries(cmake, cache, settings);
 			break;
 		case Settings::Target::ENGINE:
-			configureEngine(cmake, settings);
+			configured = configureEngine(cmake, cache, settings);
 			break;
 		case Settings::Target::GAME:
 		{
 			std::string gameName;
 			config().gameName(gameName);
 
-			configureGame(cmake, settings, gameName);
+			configured = configureGame(cmake, cache, settings, gameName);
 			break;
 		}
 	}
+
+	return configured;
+}
+
+/// Configures every build type in its own thread, as CMake script evaluation is mostly single-threaded
+void configureConcurrently(CMakeCommand &cmake, const CacheCommand &cache, const Settings &settings)
+{
+	const std::vector<Settings::BuildType> &buildTypes = settings.buildTypes();
+	const unsigned int numVariants = buildTypes.size();
+
+	std::vector<Settings> variantSettings(numVariants, settings);
+	// Every thread needs its own command to capture the output
+	std::vector<CMakeCommand> variantCommands(numVariants, cmake);
+	// The messages of every thread are printed after it has finished, so they do not interleave
+	std::vector<std::ostringstream> messages(numVariants);
+	std::vector<char> configured(numVariants, false);
+	std::vector<std::thread> threads;
+	threads.reserve(numVariants);
+
+	for (unsigned int i = 0; i < numVariants; i++)
+	{
+		variantSettings[i].setBuildType(buildTypes[i]);
+		variantCommands[i].setCaptureOutput(true);
+		threads.emplace_back([&, i] {
+			Helpers::redirectOutput(&messages[i]);
+			configured[i] = configureTarget(variantCommands[i], cache, variantSettings[i]);
+			Helpers::redirectOutput(nullptr);
+		});
+	}
+
+	for (unsigned int i = 0; i < numVariants; i++)
+	{
+		threads[i].join();
+
+		Helpers::info("Configuration output for the build type: ", Settings::buildTypeToString(buildTypes[i]));
+		std::cout << messages[i].str() << variantCommands[i].output() << std::flush;
+		if (configured[i] == false)
+			Helpers::error("Cannot configure the build type: ", Settings::buildTypeToString(buildTypes[i]));
+	}
+}
+
+}
+
+///////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////
+
+bool ConfMode::compilerLauncherArgs(std::string &cmakeArguments, const CacheCommand &cache)
+{
+	// Compiler launchers are ignored by the Visual Studio generators
+	if (cache.found() == false || CMakeCommand::generatorIsVisualStudio())
+		return false;
+
+	cmakeArguments += " -D CMAKE_C_COMPILER_LAUNCHER=" + cache.executable();
+	cmakeArguments += " -D CMAKE_CXX_COMPILER_LAUNCHER=" + cache.executable();
+
+	return true;
+}
+
+std::string ConfMode::withEnvironmentFlags(const char *name, const std::string &flags)
+{
+	const char *environmentFlags = Helpers::getEnvironment(name);
+	if (environmentFlags == nullptr || environmentFlags[0] == '\0')
+		return flags;
+
+	std::string allFlags = environmentFlags;
+	appendFlag(allFlags, flags.data());
+	return allFlags;
+}
+
+void ConfMode::ltoFlags(std::string &compileFlags, std::string &linkFlags, const CMakeCommand &cmake, bool withLinkerArgs)
+{
+	const Configuration::Platform platform = config().platform();
+#ifdef __APPLE__
+	const bool isClang = true;
+#else
+	// The Android and Emscripten toolchains are based on Clang
+	const bool isClang = (config().compiler() == Configuration::Compiler::CLANG || platform != Configuration::Platform::DESKTOP);
+#endif
+
+	if (config().lto() == Configuration::Lto::OFF)
+		return;
+	else if (config().lto() == Configuration::Lto::FULL || isClang == false)
+	{
+		// GCC has no equivalent of ThinLTO, its partitioned link-time optimization is parallelized by `-flto=auto`
+		const char *flag = isClang ? "-flto" : "-flto=auto";
+		appendFlag(compileFlags, flag);
+		appendFlag(linkFlags, flag);
+		return;
+	}
+
+	appendFlag(compileFlags, "-flto=thin");
+	appendFlag(linkFlags, "-flto=thin");
+	if (platform != Configuration::Platform::DESKTOP)
+		return;
+
+	// The cache lets the linker reuse the optimized modules that did not change since the previous link
+	std::string cacheDir;
+	if (config().thinLtoCacheDir(cacheDir) == false || cacheDir.empty())
+		cacheDir = fs::joinPath(fs::currentDir(), "ncline-thinlto-cache");
+
+#if defined(__APPLE__)
+	linkFlags += " -Wl,-cache_path_lto," + cacheDir;
+#elif defined(_WIN32)
+	linkFlags += " -Wl,--thinlto-cache-dir=" + cacheDir;
+#else
+	// Without the linker arguments the GNU linker is used, with the LLVM plugin
+	if (withLinkerArgs && withLinker(cmake) && config().linker() == Configuration::Linker::LLD)
+		linkFlags += " -Wl,--thinlto-cache-dir=" + cacheDir;
+	else
+		linkFlags += " -Wl,-plugin-opt,cache-dir=" + cacheDir;
+#endif
+}
+
+void ConfMode::engineArguments(std::string &arguments, const CMakeCommand &cmake, const CacheCommand &cache, const Settings &settings)
+{
+	engineArguments(arguments, cmake, cache, settings, std::string(), std::string());
+}
+
+void ConfMode::engineArguments(std::string &arguments, const CMakeCommand &cmake, const CacheCommand &cache, const Settings &settings,
+                               const std::string &extraCompileFlags, const std::string &extraLinkFlags)
+{
+	preferredCompilerArgs(arguments);
+	ConfMode::compilerLauncherArgs(arguments, cache);
+	buildTypeArg(arguments, settings);
+	configurationTypesArg(arguments);
+	compilerFlagsArgs(arguments, cmake, settings, extraCompileFlags);
+	linkerArgs(arguments, cmake, settings, extraLinkFlags);
+	unityBuildArgs(arguments);
+	engineAndroidArg(arguments);
+	prefixPathArg(arguments);
+	additionalEngineArgs(arguments);
+}
+
+void ConfMode::gameArguments(std::string &arguments, const CMakeCommand &cmake, const CacheCommand &cache, const Settings &settings)
+{
+	gameArguments(arguments, cmake, cache, settings, std::string(), std::string());
+}
+
+void ConfMode::gameArguments(std::string &arguments, const CMakeCommand &cmake, const CacheCommand &cache, const Settings &settings,
+                             const std::string &extraCompileFlags, const std::string &extraLinkFlags)
+{
+	preferredCompilerArgs(arguments);
+	ConfMode::compilerLauncherArgs(arguments, cache);
+	buildTypeArg(arguments, settings);
+	configurationTypesArg(arguments);
+	compilerFlagsArgs(arguments, cmake, settings, extraCompileFlags);
+	linkerArgs(arguments, cmake, settings, extraLinkFlags);
+	unityBuildArgs(arguments);
+	gameAndroidArg(arguments);
+	ncineDirArg(arguments);
+	additionalGameArgs(arguments);
+}
+
+void ConfMode::perform(CMakeCommand &cmake, CacheCommand &cache, const Settings &settings)
+{
+	assert(settings.mode() == Settings::Mode::CONF);
+
+	setupEnvironment(cmake, settings);
+
+	if (settings.profileConfiguration() && cmake.supportsProfiling() == false)
+		Helpers::error("Profiling the configuration needs at least CMake 3.18: ", cmake.executable().data());
+
+	if (settings.buildTypes().size() > 1)
+		configureConcurrently(cmake, cache, settings);
+	else
+		configureTarget(cmake, cache, settings);
+
+	if (settings.profileConfiguration() && cmake.supportsProfiling())
+	{
+		Settings buildTypeSettings(settings);
+		for (Settings::BuildType buildType : settings.buildTypes())
+		{
+			buildTypeSettings.setBuildType(buildType);
+			printProfilingReport(buildTypeSettings);
+		}
+	}
 }
@@ -1,10 +1,30 @@
 #pragma once
 
+#include <string>
+
 class Settings;
 class CMakeCommand;
+class CacheCommand;
 
 class ConfMode
 {
   public:
-	static void perform(CMakeCommand &cmake, const Settings &settings);
+	/// Appends the CMake arguments used to configure the engine, except the profiling ones
+	static void engineArguments(std::string &arguments, const CMakeCommand &cmake, const CacheCommand &cache, const Settings &settings);
+	/// Appends the CMake arguments used to configure the engine, with some compiler and linker flags after the ones of the configuration
+	static void engineArguments(std::string &arguments, const CMakeCommand &cmake, const CacheCommand &cache, const Settings &settings,
+	                            const std::string &extraCompileFlags, const std::string &extraLinkFlags);
+	/// Appends the CMake arguments used to configure the game, except the profiling ones
+	static void gameArguments(std::string &arguments, const CMakeCommand &cmake, const CacheCommand &cache, const Settings &settings);
+	/// Appends the CMake arguments used to configure the game, with some compiler and linker flags after the ones of the configuration
+	static void gameArguments(std::string &arguments, const CMakeCommand &cmake, const CacheCommand &cache, const Settings &settings,
+	                          const std::string &extraCompileFlags, const std::string &extraLinkFlags);
+	/// Appends the arguments that launch the compilers through the compiler cache, if it has been found
+	static bool compilerLauncherArgs(std::string &cmakeArguments, const CacheCommand &cache);
+	/// Prepends the flags of an environment variable, as flags passed on the command line would replace the ones CMake initializes from it
+	static std::string withEnvironmentFlags(const char *name, const std::string &flags);
+	/// Appends the compiler and linker flags of the link-time optimization mode in the configuration
+	/// \param withLinkerArgs Whether the linker chosen in the configuration is also passed to CMake, or the default one is used
+	static void ltoFlags(std::string &compileFlags, std::string &linkFlags, const CMakeCommand &cmake, bool withLinkerArgs);
+	static void perform(CMakeCommand &cmake, CacheCommand &cache, const Settings &settings);
 };
@@ -24,6 +24,7 @@ namespace Executables {
 namespace CMake {
 	const char *table = "cmake";
 	const char *withNinja = "ninja";
+	const char *withNinjaMultiConfig = "ninja_multi_config";
 	const char *withMinGW = "mingw";
 	const char *vsVersion = "vs_version";
 	const char *macosVersion = "macos_version";
@@ -39,6 +40,17 @@ namespace nCine {
 	const char *compiler = "compiler";
 	const char *compilerGCC = "gcc";
 	const char *compilerClang = "clang";
+	const char *linker = "linker";
+	const char *linkerLLD = "lld";
+	const char *linkerMold = "mold";
+	const char *withSplitDwarf = "split_dwarf";
+	const char *withCompressedDebug = "compressed_debug";
+	const char *lto = "lto";
+	const char *ltoFull = "full";
+	const char *ltoThin = "thin";
+	const char *withUnityBuild = "unity_build";
+	const char *unityBatchSize = "unity_batch_size";
+	const char *withPrecompiledHeaders = "precompiled_headers";
 	const char *cmakeArguments = "cmake_arguments";
 	const char *branch = "branch";
 	const char *ncineDir = "ncine_dir";
@@ -57,6 +69,25 @@ namespace Android {
 	const char *gradleDir = "gradle_dir";
 }
 
+namespace Cache {
+	const char *table = "cache";
+	const char *launcher = "launcher";
+	const char *launcherCcache = "ccache";
+	const char *launcherSccache = "sccache";
+	const char *directory = "directory";
+	const char *maxSize = "max_size";
+	const char *binaryDirectory = "binary_directory";
+	const char *thinLtoDirectory = "thinlto_directory";
+}
+
+namespace Build {
+	const char *table = "build";
+	const char *jobMemory = "job_memory_mb";
+	const char *withJobServer = "jobserver";
+	const char *regressionThreshold = "regression_threshold";
+	const char *withCompactProgress = "compact_progress";
+}
+
 }
 
 Configuration &config()
@@ -190,6 +221,16 @@ void Configuration::setWithNinja(bool value)
 	cmakeSection_->insert(Names::CMake::withNinja, value);
 }
 
+bool Configuration::withNinjaMultiConfig() const
+{
+	return cmakeSection_->get_as<bool>(Names::CMake::withNinjaMultiConfig).value_or(false);
+}
+
+void Configuration::setWithNinjaMultiConfig(bool value)
+{
+	cmakeSection_->insert(Names::CMake::withNinjaMultiConfig, value);
+}
+
 bool Configuration::withMinGW() const
 {
 	return cmakeSection_->get_as<bool>(Names::CMake::withMinGW).value_or(false);
@@ -257,6 +298,129 @@ void Configuration::setCompiler(Compiler compiler)
 	}
 }
 
+Configuration::Linker Configuration::linker() const
+{
+#ifndef __APPLE__
+	auto name = ncineSection_->get_as<std::string>(Names::nCine::linker);
+	if (name)
+	{
+		if (*name == Names::nCine::linkerLLD)
+			return Linker::LLD;
+		else if (*name == Names::nCine::linkerMold)
+			return Linker::MOLD;
+	}
+#endif
+	return Linker::DEFAULT;
+}
+
+void Configuration::setLinker(Linker linker)
+{
+	switch (linker)
+	{
+		case Linker::LLD:
+			ncineSection_->insert(Names::nCine::linker, Names::nCine::linkerLLD);
+			break;
+		case Linker::MOLD:
+			ncineSection_->insert(Names::nCine::linker, Names::nCine::linkerMold);
+			break;
+		case Linker::DEFAULT:
+			ncineSection_->insert(Names::nCine::linker, "");
+			break;
+	}
+}
+
+bool Configuration::withSplitDwarf() const
+{
+	return ncineSection_->get_as<bool>(Names::nCine::withSplitDwarf).value_or(false);
+}
+
+void Configuration::setWithSplitDwarf(bool value)
+{
+	ncineSection_->insert(Names::nCine::withSplitDwarf, value);
+}
+
+bool Configuration::withCompressedDebug() const
+{
+	return ncineSection_->get_as<bool>(Names::nCine::withCompressedDebug).value_or(false);
+}
+
+void Configuration::setWithCompressedDebug(bool value)
+{
+	ncineSection_->insert(Names::nCine::withCompressedDebug, value);
+}
+
+Configuration::Lto Configuration::lto() const
+{
+	auto name = ncineSection_->get_as<std::string>(Names::nCine::lto);
+	if (name)
+	{
+		if (*name == Names::nCine::ltoFull)
+			return Lto::FULL;
+		else if (*name == Names::nCine::ltoThin)
+			return Lto::THIN;
+	}
+	return Lto::OFF;
+}
+
+void Configuration::setLto(Lto lto)
+{
+	switch (lto)
+	{
+		case Lto::FULL:
+			ncineSection_->insert(Names::nCine::lto, Names::nCine::ltoFull);
+			break;
+		case Lto::THIN:
+			ncineSection_->insert(Names::nCine::lto, Names::nCine::ltoThin);
+			break;
+		case Lto::OFF:
+			ncineSection_->insert(Names::nCine::lto, "");
+			break;
+	}
+}
+
+bool Configuration::hasUnityBuild() const
+{
+	return ncineSection_->get_as<bool>(Names::nCine::withUnityBuild).operator bool();
+}
+
+bool Configuration::withUnityBuild() const
+{
+	return ncineSection_->get_as<bool>(Names::nCine::withUnityBuild).value_or(false);
+}
+
+void Configuration::setWithUnityBuild(bool value)
+{
+	ncineSection_->insert(Names::nCine::withUnityBuild, value);
+}
+
+unsigned int Configuration::unityBatchSize() const
+{
+	return ncineSection_->get_as<unsigned int>(Names::nCine::unityBatchSize).value_or(8);
+}
+
+void Configuration::setUnityBatchSize(unsigned int size)
+{
+	if (size > 0)
+		ncineSection_->insert(Names::nCine::unityBatchSize, size);
+	else
+		ncineSection_->insert(Names::nCine::unityBatchSize, 8);
+}
+
+bool Configuration::hasPrecompiledHeaders() const
+{
+	return ncineSection_->get_as<bool>(Names::nCine::withPrecompiledHeaders).operator bool();
+}
+
+bool Configuration::withPrecompiledHeaders() const
+{
+	return ncineSection_->get_as<bool>(Names::nCine::withPrecompiledHeaders).value_or(true);
+}
+
+void Configuration::setWithPrecompiledHeaders(bool value)
+{
+	ncineSection_->insert(Names::nCine::withPrecompiledHeaders, value);
+}
+
 Configuration::AndroidArch Configuration::androidArch() const
 {
 	auto name = androidSection_->get_as<std::string>(Names::Android::architecture);
@@ -396,6 +560,118 @@ void Configuration::setGameCMakeArguments(const std::string &value)
 	ncineSection_->insert(Names::nCine::gameCmakeArguments, value);
 }
 
+Configuration::CompilerCache Configuration::compilerCache() const
+{
+	auto name = cacheSection_->get_as<std::string>(Names::Cache::launcher);
+	if (name)
+	{
+		if (*name == Names::Cache::launcherCcache)
+			return CompilerCache::CCACHE;
+		else if (*name == Names::Cache::launcherSccache)
+			return CompilerCache::SCCACHE;
+	}
+	return CompilerCache::NONE;
+}
+
+void Configuration::setCompilerCache(CompilerCache compilerCache)
+{
+	switch (compilerCache)
+	{
+		case CompilerCache::CCACHE:
+			cacheSection_->insert(Names::Cache::launcher, Names::Cache::launcherCcache);
+			break;
+		case CompilerCache::SCCACHE:
+			cacheSection_->insert(Names::Cache::launcher, Names::Cache::launcherSccache);
+			break;
+		case CompilerCache::NONE:
+			cacheSection_->insert(Names::Cache::launcher, "");
+			break;
+	}
+}
+
+bool Configuration::compilerCacheDir(std::string &value) const
+{
+	return retrieveString(cacheSection_, Names::Cache::directory, value);
+}
+
+void Configuration::setCompilerCacheDir(const std::string &value)
+{
+	cacheSection_->insert(Names::Cache::directory, value);
+}
+
+bool Configuration::compilerCacheSize(std::string &value) const
+{
+	return retrieveString(cacheSection_, Names::Cache::maxSize, value);
+}
+
+void Configuration::setCompilerCacheSize(const std::string &value)
+{
+	cacheSection_->insert(Names::Cache::maxSize, value);
+}
+
+bool Configuration::binaryCacheDir(std::string &value) const
+{
+	return retrieveString(cacheSection_, Names::Cache::binaryDirectory, value);
+}
+
+void Configuration::setBinaryCacheDir(const std::string &value)
+{
+	cacheSection_->insert(Names::Cache::binaryDirectory, value);
+}
+
+bool Configuration::thinLtoCacheDir(std::string &value) const
+{
+	return retrieveString(cacheSection_, Names::Cache::thinLtoDirectory, value);
+}
+
+void Configuration::setThinLtoCacheDir(const std::string &value)
+{
+	cacheSection_->insert(Names::Cache::thinLtoDirectory, value);
+}
+
+unsigned int Configuration::jobMemory() const
+{
+	return buildSection_->get_as<unsigned int>(Names::Build::jobMemory).value_or(2048);
+}
+
+void Configuration::setJobMemory(unsigned int megabytes)
+{
+	if (megabytes > 0)
+		buildSection_->insert(Names::Build::jobMemory, megabytes);
+	else
+		buildSection_->insert(Names::Build::jobMemory, 2048);
+}
+
+bool Configuration::withJobServer() const
+{
+	return buildSection_->get_as<bool>(Names::Build::withJobServer).value_or(false);
+}
+
+void Configuration::setWithJobServer(bool value)
+{
+	buildSection_->insert(Names::Build::withJobServer, value);
+}
+
+unsigned int Configuration::regressionThreshold() const
+{
+	return buildSection_->get_as<unsigned int>(Names::Build::regressionThreshold).value_or(20);
+}
+
+void Configuration::setRegressionThreshold(unsigned int percent)
+{
+	buildSection_->insert(Names::Build::regressionThreshold, percent);
+}
+
+bool Configuration::withCompactProgress() const
+{
+	return buildSection_->get_as<bool>(Names::Build::withCompactProgress).value_or(false);
+}
+
+void Configuration::setWithCompactProgress(bool value)
+{
+	buildSection_->insert(Names::Build::withCompactProgress, value);
+}
+
 void Configuration::print() const
 {
 	std::cout << *root_;
@@ -462,4 +738,18 @@ void Configuration::retrieveSections()
 		androidSection_ = cpptoml::make_table();
 		root_->insert(Names::Android::table, androidSection_);
 	}
+
+	cacheSection_ = root_->get_table(Names::Cache::table);
+	if (cacheSection_ == nullptr)
+	{
+		cacheSection_ = cpptoml::make_table();
+		root_->insert(Names::Cache::table, cacheSection_);
+	}
+
+	buildSection_ = root_->get_table(Names::Build::table);
+	if (buildSection_ == nullptr)
+	{
+		buildSection_ = cpptoml::make_table();
+		root_->insert(Names::Build::table, buildSection_);
+	}
 }
@@ -28,6 +28,20 @@ class Configuration
 		UNSPECIFIED
 	};
 
+	enum class Linker
+	{
+		DEFAULT,
+		LLD,
+		MOLD
+	};
+
+	enum class Lto
+	{
+		OFF,
+		FULL,
+		THIN
+	};
+
 	enum class AndroidArch
 	{
 		ARMEABI_V7A,
@@ -37,6 +51,13 @@ class Configuration
 		UNSPECIFIED
 	};
 
+	enum class CompilerCache
+	{
+		NONE,
+		CCACHE,
+		SCCACHE
+	};
+
 	Configuration();
 
 	bool withColors() const;
@@ -59,6 +80,9 @@ class Configuration
 	bool withNinja() const;
 	void setWithNinja(bool value);
 
+	bool withNinjaMultiConfig() const;
+	void setWithNinjaMultiConfig(bool value);
+
 	bool withMinGW() const;
 	void setWithMinGW(bool value);
 
@@ -71,6 +95,29 @@ class Configuration
 	Compiler compiler() const;
 	void setCompiler(Compiler compiler);
 
+	Linker linker() const;
+	void setLinker(Linker linker);
+
+	bool withSplitDwarf() const;
+	void setWithSplitDwarf(bool value);
+
+	bool withCompressedDebug() const;
+	void setWithCompressedDebug(bool value);
+
+	Lto lto() const;
+	void setLto(Lto lto);
+
+	bool hasUnityBuild() const;
+	bool withUnityBuild() const;
+	void setWithUnityBuild(bool value);
+
+	unsigned int unityBatchSize() const;
+	void setUnityBatchSize(unsigned int size);
+
+	bool hasPrecompiledHeaders() const;
+	bool withPrecompiledHeaders() const;
+	void setWithPrecompiledHeaders(bool value);
+
 	AndroidArch androidArch() const;
 	void setAndroidArch(AndroidArch arch);
 
@@ -104,6 +151,33 @@ class Configuration
 	bool gameCMakeArguments(std::string &value) const;
 	void setGameCMakeArguments(const std::string &value);
 
+	CompilerCache compilerCache() const;
+	void setCompilerCache(CompilerCache compilerCache);
+
+	bool compilerCacheDir(std::string &value) const;
+	void setCompilerCacheDir(const std::string &value);
+
+	bool compilerCacheSize(std::string &value) const;
+	void setCompilerCacheSize(const std::string &value);
+
+	bool binaryCacheDir(std::string &value) const;
+	void setBinaryCacheDir(const std::string &value);
+
+	bool thinLtoCacheDir(std::string &value) const;
+	void setThinLtoCacheDir(const std::string &value);
+
+	unsigned int jobMemory() const;
+	void setJobMemory(unsigned int megabytes);
+
+	bool withJobServer() const;
+	void setWithJobServer(bool value);
+
+	unsigned int regressionThreshold() const;
+	void setRegressionThreshold(unsigned int percent);
+
+	bool withCompactProgress() const;
+	void setWithCompactProgress(bool value);
+
 	void print() const;
 	void save();
 
@@ -113,6 +187,8 @@ class Configuration
 	std::shared_ptr<cpptoml::table> cmakeSection_;
 	std::shared_ptr<cpptoml::table> ncineSection_;
 	std::shared_ptr<cpptoml::table> androidSection_;
+	std::shared_ptr<cpptoml::table> cacheSection_;
+	std::shared_ptr<cpptoml::table> buildSection_;
 
 	bool hasString(const std::shared_ptr<cpptoml::table> &section, const char *name) const;
 	bool retrieveString(const std::shared_ptr<cpptoml::table> &section, const char *name, std::string &dest) const;
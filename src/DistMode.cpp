@@ -1,9 +1,19 @@
 #include <cassert>
 #include "DistMode.h"
+#include "GitCommand.h"
 #include "CMakeCommand.h"
+#include "CacheCommand.h"
+#include "ConfMode.h"
+#include "JobCount.h"
+#include "JobServer.h"
+#include "NinjaLog.h"
+#include "BuildHistory.h"
+#include "BinarySize.h"
+#include "Trash.h"
 #include "FileSystem.h"
 #include "Settings.h"
 #include "Configuration.h"
+#include "Process.h"
 #include "Helpers.h"
 
 namespace {
@@ -43,14 +53,35 @@ bool releaseBuildTypeArg(std::string &cmakeArguments)
 	return argumentsAdded;
 }
 
+bool ltoArgs(std::string &cmakeArguments, const CMakeCommand &cmake)
+{
+	// Visual Studio generators are only used for the MSVC compiler
+	if (CMakeCommand::generatorIsVisualStudio() && config().platform() != Configuration::Platform::ANDROID)
+		return false;
+
+	std::string compileFlags;
+	std::string linkFlags;
+	// Flags are always passed, to revert the ones stored in the cache of an existing directory, but keep the environment ones
+	// Distributions are linked by the default linker
+	ConfMode::ltoFlags(compileFlags, linkFlags, cmake, false);
+	linkFlags = ConfMode::withEnvironmentFlags("LDFLAGS", linkFlags);
+	cmakeArguments += " -D CMAKE_C_FLAGS=\"" + ConfMode::withEnvironmentFlags("CFLAGS", compileFlags) + "\"";
+	cmakeArguments += " -D CMAKE_CXX_FLAGS=\"" + ConfMode::withEnvironmentFlags("CXXFLAGS", compileFlags) + "\"";
+	cmakeArguments += " -D CMAKE_EXE_LINKER_FLAGS=\"" + linkFlags + "\"";
+	cmakeArguments += " -D CMAKE_SHARED_LINKER_FLAGS=\"" + linkFlags + "\"";
+	cmakeArguments += " -D CMAKE_MODULE_LINKER_FLAGS=\"" + linkFlags + "\"";
+
+	return true;
+}
+
 void buildReleaseAndPackage(CMakeCommand &cmake, const char *buildDir)
 {
 	assert(buildDir);
 
 	if (CMakeCommand::generatorIsMultiConfig())
 	{
-		cmake.buildConfig(buildDir, "release");
-		cmake.build(buildDir, "release", "package");
+		cmake.buildConfig(buildDir, "Release");
+		cmake.build(buildDir, "Release", "package");
 	}
 	else
 	{
@@ -64,16 +95,30 @@ bool cleanDistDir(CMakeCommand &cmake, const Settings &settings, const std::stri
 	if (settings.clean() && fs::isDirectory(buildDir.data()))
 	{
 		Helpers::info("Remove the build directory: ", buildDir.data());
-		std::string cleanCommand = cmake.removeDir() + buildDir;
-		bool executed = cmake.toolsMode(cleanCommand.data());
-
-		return executed;
+		return Trash::removeDir(cmake, buildDir);
 	}
 
 	return false;
 }
 
-void distributeEngine(CMakeCommand &cmake, const Settings &settings)
+/// Compares the size of the distributed binaries with the last distribution, then stores it as the new baseline
+void recordBinarySize(CMakeCommand &cmake, const std::string &buildDir)
+{
+	BinarySize current;
+	if (current.addDirectory(buildDir) == 0)
+		return;
+
+	const std::string snapshotFile = BinarySize::snapshotFile(buildDir);
+	BinarySize baseline;
+	if (baseline.load(snapshotFile))
+		BinarySize::printTotalDelta(baseline, current);
+
+	const std::string makeDirCommand = std::string("make_directory ") + BinarySize::snapshotsDir();
+	if (cmake.toolsMode(makeDirCommand.data()) == false || current.save(snapshotFile) == false)
+		Helpers::error("Cannot store the size of the binaries: ", snapshotFile.data());
+}
+
+void distributeEngine(CMakeCommand &cmake, const CacheCommand &cache, const Settings &settings)
 {
 	cmake.addAndroidNdkDirToPath();
 	cmake.addDoxygenDirToPath();
@@ -87,12 +132,14 @@ void distributeEngine(CMakeCommand &cmake, const Settings &settings)
 	std::string arguments;
 	devDistEngineArg(arguments);
 	releaseBuildTypeArg(arguments);
+	ltoArgs(arguments, cmake);
+	ConfMode::compilerLauncherArgs(arguments, cache);
 
 	cmake.configure(Helpers::nCineSourceDir(), buildDir.data(), arguments.empty() ? nullptr : arguments.data());
 	buildReleaseAndPackage(cmake, buildDir.data());
 }
 
-void distributeGame(CMakeCommand &cmake, const Settings &settings, const std::string &gameName)
+void distributeGame(CMakeCommand &cmake, const CacheCommand &cache, const Settings &settings, const std::string &gameName)
 {
 	Helpers::info("Distribute the game: ", gameName.data());
 
@@ -103,6 +150,8 @@ void distributeGame(CMakeCommand &cmake, const Settings &settings, const std::st
 	std::string arguments;
 	devDistGameArg(arguments);
 	releaseBuildTypeArg(arguments);
+	ltoArgs(arguments, cmake);
+	ConfMode::compilerLauncherArgs(arguments, cache);
 	ncineDirArg(arguments);
 
 	cmake.configure(gameName.data(), buildDir.data(), arguments.empty() ? nullptr : arguments.data());
@@ -115,25 +164,67 @@ void distributeGame(CMakeCommand &cmake, const Settings &settings, const std::st
 // PUBLIC FUNCTIONS
 ///////////////////////////////////////////////////////////
 
-void DistMode::perform(CMakeCommand &cmake, const Settings &settings)
+void DistMode::perform(GitCommand &git, CMakeCommand &cmake, CacheCommand &cache, const Settings &settings)
 {
 	assert(settings.mode() == Settings::Mode::DIST);
 	assert(settings.target() != Settings::Target::LIBS);
 
+	std::string jobsReason;
+	cmake.setJobs(JobCount::compute(settings.jobs(), jobsReason));
+	JobCount::print(cmake.jobs(), jobsReason);
+	const unsigned int jobs = cmake.jobs();
+
+	JobServer jobServer;
+	jobServer.start(cmake);
+
+	std::string buildDir = (settings.target() == Settings::Target::ENGINE) ? Helpers::nCineSourceDir() : std::string();
+	if (settings.target() == Settings::Target::GAME)
+		config().gameName(buildDir);
+	Helpers::distDir(buildDir, settings);
+
+	NinjaLog ninjaLog;
+	const std::string logFile = NinjaLog::logFile(buildDir);
+	const bool withNinjaLog = config().withNinja() && cmake.ninjaFound() && CMakeCommand::generatorIsVisualStudio() == false && Process::dryRun == false;
+	// A clean distribution starts a new log
+	const unsigned int numRecords = (withNinjaLog && settings.clean() == false && ninjaLog.load(logFile.data())) ? ninjaLog.numRecords() : 0;
+
+	BuildHistory::Run run;
+	BuildHistory::beginRun(run, settings, jobs);
+
 	switch (settings.target())
 	{
 		case Settings::Target::LIBS:
 			break;
 		case Settings::Target::ENGINE:
-			distributeEngine(cmake, settings);
+			distributeEngine(cmake, cache, settings);
 			break;
 		case Settings::Target::GAME:
 		{
 			std::string gameName;
 			config().gameName(gameName);
 
-			distributeGame(cmake, settings, gameName);
+			distributeGame(cmake, cache, settings, gameName);
 			break;
 		}
 	}
+	if (Process::dryRun == false)
+	{
+		// Building and packaging are two different Ninja runs, the new records of both are counted
+		const unsigned int numSteps = (withNinjaLog && ninjaLog.load(logFile.data()) && ninjaLog.numRecords() > numRecords) ? ninjaLog.numRecords() - numRecords : 0;
+
+		BuildHistory::endRun(run, git, numSteps);
+		if (numSteps > 0)
+		{
+			BuildHistory::setLinkStats(run, ninjaLog, buildDir);
+			BuildHistory::printLinkStats(run);
+		}
+
+		BuildHistory history;
+		history.load();
+		if (history.append(run) == false)
+			Helpers::error("Cannot record the distribution in the history: ", BuildHistory::historyFile());
+		history.printOptionsDelta(run, false);
+
+		recordBinarySize(cmake, buildDir);
+	}
 }
@@ -1,10 +1,12 @@
 #pragma once
 
 class Settings;
+class GitCommand;
 class CMakeCommand;
+class CacheCommand;
 
 class DistMode
 {
   public:
-	static void perform(CMakeCommand &cmake, const Settings &settings);
+	static void perform(GitCommand &git, CMakeCommand &cmake, CacheCommand &cache, const Settings &settings);
 };
@@ -1,4 +1,9 @@
 #include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+#include <sstream>
+#include <vector>
 #include "FileSystem.h"
 
 #ifdef _WIN32
@@ -7,16 +12,16 @@
 	#include <WinBase.h>
 	#include <fileapi.h>
 #else
-	#include <cstring>
 	#include <unistd.h>
 	#include <sys/stat.h>
 	#include <libgen.h>
+	#include <dirent.h>
 #endif
 
 namespace {
 
 const int MaxLength = 512;
-char buffer[MaxLength];
+thread_local char buffer[MaxLength];
 
 }
 
@@ -82,6 +87,51 @@ std::string FileSystem::absolutePath(const char *relativePath)
 	return std::string(buffer);
 }
 
+bool FileSystem::isAbsolute(const std::string &path)
+{
+	return (path.empty() == false && (path[0] == '/' || path[0] == '\\' || (path.size() > 1 && path[1] == ':')));
+}
+
+bool FileSystem::endsWith(const std::string &path, const char *suffix)
+{
+	const size_t length = strlen(suffix);
+	return (path.size() >= length && path.compare(path.size() - length, length, suffix) == 0);
+}
+
+bool FileSystem::isSourceFile(const std::string &path)
+{
+	return (endsWith(path, ".c") || endsWith(path, ".cc") || endsWith(path, ".cpp") || endsWith(path, ".cxx") ||
+	        endsWith(path, ".m") || endsWith(path, ".mm"));
+}
+
+std::string FileSystem::normalizePath(const std::string &path)
+{
+	std::string string(path);
+	std::replace(string.begin(), string.end(), '\\', '/');
+
+	std::vector<std::string> components;
+	std::string component;
+	std::istringstream stream(string);
+	while (std::getline(stream, component, '/'))
+	{
+		if (component.empty() || component == ".")
+			continue;
+		else if (component == ".." && components.empty() == false && components.back() != "..")
+			components.pop_back();
+		else
+			components.push_back(component);
+	}
+
+	std::string normalized = (string.empty() == false && string[0] == '/') ? "/" : "";
+	for (unsigned int i = 0; i < components.size(); i++)
+	{
+		if (i > 0)
+			normalized += '/';
+		normalized += components[i];
+	}
+	return normalized;
+}
+
 std::string FileSystem::currentDir()
 {
 #ifdef _WIN32
@@ -120,3 +170,126 @@ bool FileSystem::canAccess(const char *file)
 	return (access(file, R_OK) == 0);
 #endif
 }
+
+bool FileSystem::exists(const char *path)
+{
+#ifdef _WIN32
+	const DWORD attrs = GetFileAttributesA(path);
+	return (attrs != INVALID_FILE_ATTRIBUTES);
+#else
+	return (access(path, F_OK) == 0);
+#endif
+}
+
+unsigned long long FileSystem::fileSize(const char *path)
+{
+	assert(path);
+#ifdef _WIN32
+	WIN32_FILE_ATTRIBUTE_DATA attributes;
+	if (GetFileAttributesExA(path, GetFileExInfoStandard, &attributes) == 0)
+		return 0;
+	return (static_cast<unsigned long long>(attributes.nFileSizeHigh) << 32) | attributes.nFileSizeLow;
+#else
+	struct stat sb;
+	if (stat(path, &sb) == -1 || (sb.st_mode & S_IFMT) != S_IFREG)
+		return 0;
+	return static_cast<unsigned long long>(sb.st_size);
+#endif
+}
+
+bool FileSystem::listFiles(const char *directory, std::vector<std::string> &files)
+{
+	assert(directory);
+#ifdef _WIN32
+	const std::string pattern = joinPath(directory, "*");
+	WIN32_FIND_DATAA findData;
+	HANDLE findHandle = FindFirstFileA(pattern.data(), &findData);
+	if (findHandle == INVALID_HANDLE_VALUE)
+		return false;
+
+	do
+	{
+		if (strcmp(findData.cFileName, ".") == 0 || strcmp(findData.cFileName, "..") == 0)
+			continue;
+
+		const std::string path = joinPath(directory, findData.cFileName);
+		if (findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+			listFiles(path.data(), files);
+		else
+			files.push_back(path);
+	} while (FindNextFileA(findHandle, &findData));
+
+	FindClose(findHandle);
+	return true;
+#else
+	DIR *dir = opendir(directory);
+	if (dir == nullptr)
+		return false;
+
+	while (const struct dirent *entry = readdir(dir))
+	{
+		if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0)
+			continue;
+
+		const std::string path = joinPath(directory, entry->d_name);
+		struct stat sb;
+		if (lstat(path.data(), &sb) == -1)
+			continue;
+
+		// Symbolic links are not followed to avoid cycles
+		if ((sb.st_mode & S_IFMT) == S_IFDIR)
+			listFiles(path.data(), files);
+		else if ((sb.st_mode & S_IFMT) == S_IFREG)
+			files.push_back(path);
+	}
+
+	closedir(dir);
+	return true;
+#endif
+}
+
+bool FileSystem::listEntries(const char *directory, std::vector<std::string> &entries)
+{
+	assert(directory);
+#ifdef _WIN32
+	const std::string pattern = joinPath(directory, "*");
+	WIN32_FIND_DATAA findData;
+	HANDLE findHandle = FindFirstFileA(pattern.data(), &findData);
+	if (findHandle == INVALID_HANDLE_VALUE)
+		return false;
+
+	do
+	{
+		if (strcmp(findData.cFileName, ".") != 0 && strcmp(findData.cFileName, "..") != 0)
+			entries.push_back(joinPath(directory, findData.cFileName));
+	} while (FindNextFileA(findHandle, &findData));
+
+	FindClose(findHandle);
+	return true;
+#else
+	DIR *dir = opendir(directory);
+	if (dir == nullptr)
+		return false;
+
+	while (const struct dirent *entry = readdir(dir))
+	{
+		if (strcmp(entry->d_name, ".") != 0 && strcmp(entry->d_name, "..") != 0)
+			entries.push_back(joinPath(directory, entry->d_name));
+	}
+
+	closedir(dir);
+	return true;
+#endif
+}
+
+bool FileSystem::rename(const char *oldPath, const char *newPath)
+{
+	assert(oldPath);
+	assert(newPath);
+#ifdef _WIN32
+	// Directories cannot be moved to another volume without copying
+	return (MoveFileA(oldPath, newPath) != 0);
+#else
+	return (std::rename(oldPath, newPath) == 0);
+#endif
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 class FileSystem
 {
@@ -9,9 +10,27 @@ class FileSystem
 	static std::string dirName(const char *path);
 	static std::string baseName(const char *path);
 	static std::string absolutePath(const char *relativePath);
+	/// Returns true if a path starts from a root or from a drive letter
+	static bool isAbsolute(const std::string &path);
+	/// Returns true if a path ends with a suffix, like a file extension
+	static bool endsWith(const std::string &path, const char *suffix);
+	/// Returns true if a path has the extension of a C, C++ or Objective-C source file
+	static bool isSourceFile(const std::string &path);
+	/// Removes the `.` and `..` components of a path without accessing the file system, as the file could have been deleted
+	static std::string normalizePath(const std::string &path);
 	static std::string currentDir();
 	static bool isDirectory(const char *file);
 	static bool canAccess(const char *file);
+	/// Returns true if a file or a directory exists, without reporting an error otherwise
+	static bool exists(const char *path);
+	/// Returns the size of a regular file in bytes, or zero if it cannot be retrieved
+	static unsigned long long fileSize(const char *path);
+	/// Appends the paths of all the regular files inside a directory and its subdirectories
+	static bool listFiles(const char *directory, std::vector<std::string> &files);
+	/// Appends the paths of the files and the directories directly inside a directory
+	static bool listEntries(const char *directory, std::vector<std::string> &entries);
+	/// Moves a file or a directory, which does not copy anything when the new path is on the same file system
+	static bool rename(const char *oldPath, const char *newPath);
 };
 
 using fs = FileSystem;
@@ -0,0 +1,207 @@
+#include <cassert>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include "FileWatcher.h"
+#include "FileSystem.h"
+#include "Helpers.h"
+
+#ifdef __linux__
+	#include <dirent.h>
+	#include <poll.h>
+	#include <unistd.h>
+	#include <sys/inotify.h>
+	#include <sys/stat.h>
+#endif
+
+namespace {
+
+#ifdef __linux__
+const uint32_t WatchMask = IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF;
+#endif
+
+/// Repository metadata, editor swap and backup files do not trigger a build
+bool isIgnored(const char *name)
+{
+	const size_t length = strlen(name);
+	return (length == 0 || name[0] == '.' || name[0] == '#' || name[length - 1] == '~');
+}
+
+}
+
+///////////////////////////////////////////////////////////
+// CONSTRUCTORS and DESTRUCTOR
+///////////////////////////////////////////////////////////
+
+FileWatcher::FileWatcher()
+    : fd_(-1)
+{
+#ifdef __linux__
+	fd_ = inotify_init1(IN_CLOEXEC | IN_NONBLOCK);
+	if (fd_ < 0)
+		Helpers::error("Cannot initialize inotify: ", strerror(errno));
+#endif
+}
+
+FileWatcher::~FileWatcher()
+{
+#ifdef __linux__
+	if (fd_ >= 0)
+		close(fd_);
+#endif
+}
+
+///////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////
+
+bool FileWatcher::isSupported()
+{
+#ifdef __linux__
+	return true;
+#else
+	return false;
+#endif
+}
+
+bool FileWatcher::addDirectory(const std::string &directory)
+{
+	if (fd_ < 0 || fs::isDirectory(directory.data()) == false)
+		return false;
+
+	roots_.push_back(directory);
+	return addWatches(directory, static_cast<unsigned int>(roots_.size() - 1));
+}
+
+unsigned int FileWatcher::waitForChanges(unsigned int quietPeriod, std::vector<bool> &changedDirs)
+{
+	changedDirs.assign(roots_.size(), false);
+	// A file usually generates more than one event when it is saved
+	std::unordered_set<std::string> changedFiles;
+#ifdef __linux__
+	if (fd_ < 0)
+		return 0;
+
+	struct pollfd pollFd;
+	pollFd.fd = fd_;
+	pollFd.events = POLLIN;
+
+	// Changes that happened during the previous build are already queued and start a new batch immediately
+	while (changedFiles.empty())
+	{
+		pollFd.revents = 0;
+		if (poll(&pollFd, 1, -1) < 0 && errno != EINTR)
+			return 0;
+		readEvents(changedDirs, changedFiles);
+	}
+
+	// Saving many files at once generates bursts of events that should result in a single build
+	for (;;)
+	{
+		pollFd.revents = 0;
+		const int ready = poll(&pollFd, 1, static_cast<int>(quietPeriod));
+		if (ready < 0 && errno != EINTR)
+			break;
+		else if (ready == 0)
+			break;
+		readEvents(changedDirs, changedFiles);
+	}
+#endif
+	return static_cast<unsigned int>(changedFiles.size());
+}
+
+///////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+///////////////////////////////////////////////////////////
+
+bool FileWatcher::addWatches(const std::string &directory, unsigned int root)
+{
+#ifdef __linux__
+	const int wd = inotify_add_watch(fd_, directory.data(), WatchMask | IN_ONLYDIR);
+	if (wd < 0)
+	{
+		if (errno == ENOSPC)
+			Helpers::error("Too many watched directories, increase the 'fs.inotify.max_user_watches' kernel parameter");
+		else
+			Helpers::error("Cannot watch the directory: ", directory.data());
+		return false;
+	}
+	watches_[wd] = { directory, root };
+
+	DIR *dir = opendir(directory.data());
+	if (dir == nullptr)
+		return false;
+
+	bool added = true;
+	while (const struct dirent *entry = readdir(dir))
+	{
+		if (isIgnored(entry->d_name))
+			continue;
+
+		const std::string path = fs::joinPath(directory, entry->d_name);
+		struct stat sb;
+		// Symbolic links are not followed to avoid cycles
+		if (lstat(path.data(), &sb) == 0 && (sb.st_mode & S_IFMT) == S_IFDIR)
+			added = addWatches(path, root) && added;
+	}
+
+	closedir(dir);
+	return added;
+#else
+	return false;
+#endif
+}
+
+void FileWatcher::readEvents(std::vector<bool> &changedDirs, std::unordered_set<std::string> &changedFiles)
+{
+#ifdef __linux__
+	alignas(struct inotify_event) char buffer[4096];
+	for (;;)
+	{
+		const ssize_t length = read(fd_, buffer, sizeof(buffer));
+		if (length <= 0)
+			break;
+
+		for (ssize_t offset = 0; offset < length;)
+		{
+			const struct inotify_event *event = reinterpret_cast<const struct inotify_event *>(buffer + offset);
+			offset += sizeof(struct inotify_event) + event->len;
+
+			// Events were lost, including the creation of subdirectories that are not watched yet
+			if (event->mask & IN_Q_OVERFLOW)
+			{
+				Helpers::info("The queue of file events overflowed, all the watched directories are considered changed");
+				for (unsigned int i = 0; i < roots_.size(); i++)
+				{
+					addWatches(roots_[i], i);
+					changedDirs[i] = true;
+					changedFiles.insert(roots_[i]);
+				}
+				continue;
+			}
+
+			auto watchIt = watches_.find(event->wd);
+			if (watchIt == watches_.end())
+				continue;
+
+			if (event->mask & (IN_DELETE_SELF | IN_IGNORED))
+			{
+				watches_.erase(watchIt);
+				continue;
+			}
+			if (event->len == 0 || isIgnored(event->name))
+				continue;
+
+			const Watch watch = watchIt->second;
+			// New subdirectories are watched too, the files they already contain are not reported
+			if ((event->mask & IN_ISDIR) && (event->mask & (IN_CREATE | IN_MOVED_TO)))
+				addWatches(fs::joinPath(watch.path, event->name), watch.root);
+			else if ((event->mask & IN_ISDIR) == 0)
+			{
+				changedDirs[watch.root] = true;
+				changedFiles.insert(fs::joinPath(watch.path, event->name));
+			}
+		}
+	}
+#endif
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+
+/// A recursive watcher of directory trees, based on inotify
+class FileWatcher
+{
+  public:
+	FileWatcher();
+	~FileWatcher();
+
+	/// Returns true if the platform can notify file changes
+	static bool isSupported();
+
+	/// Watches a directory and all its subdirectories, its changes are reported at the index of the order of addition
+	bool addDirectory(const std::string &directory);
+	inline unsigned int numWatches() const { return static_cast<unsigned int>(watches_.size()); }
+
+	/// Blocks until some files change, then waits for a quiet period to coalesce the following changes in the same batch
+	/// \return The number of changed files, with the flags of the directories that contain them
+	unsigned int waitForChanges(unsigned int quietPeriod, std::vector<bool> &changedDirs);
+
+  private:
+	struct Watch
+	{
+		std::string path;
+		/// The index of the added directory that contains this one
+		unsigned int root;
+	};
+
+	int fd_;
+	std::vector<std::string> roots_;
+	std::unordered_map<int, Watch> watches_;
+
+	bool addWatches(const std::string &directory, unsigned int root);
+	void readEvents(std::vector<bool> &changedDirs, std::unordered_set<std::string> &changedFiles);
+
+	FileWatcher(const FileWatcher &) = delete;
+	FileWatcher &operator=(const FileWatcher &) = delete;
+};
@@ -0,0 +1,325 @@
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include "FlameGraph.h"
+#include "FileSystem.h"
+#include "Helpers.h"
+
+namespace {
+
+const unsigned int ImageWidth = 1200;
+const unsigned int FrameHeight = 16;
+const unsigned int Padding = 10;
+const unsigned int TitleHeight = 30;
+const unsigned int FontSize = 12;
+/// The average width of a character of the font, relative to its size
+const float CharWidthRatio = 0.59f;
+/// Frames narrower than this number of pixels are not drawn
+const float MinFrameWidth = 0.1f;
+
+bool isBlank(char c)
+{
+	return (c == ' ' || c == '\t');
+}
+
+/// Returns true for a process identifier, optionally followed by a thread identifier
+bool isPid(const std::string &token)
+{
+	return (token.empty() == false && token.find_first_not_of("0123456789/") == std::string::npos && token[0] != '/');
+}
+
+/// Extracts the command name from the header of a sample, like `name 1234/1235 [002] 10.5: 1001 cycles:`
+std::string parseCommandName(const std::string &line)
+{
+	std::vector<std::string> tokens;
+	size_t start = 0;
+	while (start < line.size())
+	{
+		while (start < line.size() && isBlank(line[start]))
+			start++;
+		size_t end = start;
+		while (end < line.size() && isBlank(line[end]) == false)
+			end++;
+		if (end > start)
+			tokens.push_back(line.substr(start, end - start));
+		start = end;
+	}
+
+	// Command names can contain spaces
+	std::string name;
+	for (unsigned int i = 0; i < tokens.size(); i++)
+	{
+		if (i > 0 && isPid(tokens[i]))
+			break;
+		name += (i > 0 ? " " : "") + tokens[i];
+	}
+	return name;
+}
+
+/// Extracts the symbol from a frame of a call stack, like `7f3a1b2c3d4e symbol+0x12 (/usr/lib/library.so)`
+std::string parseFrame(const std::string &line)
+{
+	const std::string frame = Helpers::trim(line);
+	const size_t space = frame.find(' ');
+	if (space == std::string::npos)
+		return std::string();
+
+	std::string symbol = frame.substr(space + 1);
+	std::string dso;
+	const size_t paren = symbol.rfind(" (");
+	if (symbol.empty() == false && symbol.back() == ')' && paren != std::string::npos)
+	{
+		dso = symbol.substr(paren + 2, symbol.size() - paren - 3);
+		symbol.erase(paren);
+	}
+
+	const size_t offset = symbol.rfind("+0x");
+	if (offset != std::string::npos && symbol.find_first_not_of("0123456789abcdef", offset + 3) == std::string::npos)
+		symbol.erase(offset);
+
+	// Frames without symbols are at least grouped by the library they belong to
+	if (symbol.empty() || symbol == "[unknown]")
+		symbol = dso.empty() ? "[unknown]" : "[" + fs::baseName(dso.data()) + "]";
+	// Semicolons separate the frames of a folded stack
+	std::replace(symbol.begin(), symbol.end(), ';', ':');
+
+	return symbol;
+}
+
+/// Returns a warm color that only depends on the name, so that a function has the same color in every graph
+void frameColor(const std::string &name, unsigned int &red, unsigned int &green, unsigned int &blue)
+{
+	// FNV-1a hash
+	unsigned int hash = 2166136261u;
+	for (const char c : name)
+	{
+		hash ^= static_cast<unsigned char>(c);
+		hash *= 16777619u;
+	}
+
+	red = 205 + ((hash >> 16) & 0xff) * 50 / 255;
+	green = (hash & 0xff) * 230 / 255;
+	blue = ((hash >> 8) & 0xff) * 55 / 255;
+}
+
+}
+
+///////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////
+
+bool FlameGraph::addPerfScript(const char *filename)
+{
+	std::ifstream file(filename);
+	if (file.is_open() == false)
+		return false;
+
+	std::vector<std::string> frames;
+	bool inSample = false;
+	std::string line;
+	while (std::getline(file, line))
+	{
+		if (line.empty() == false && line.back() == '\r')
+			line.pop_back();
+
+		if (Helpers::trim(line).empty())
+		{
+			if (inSample)
+				addStack(frames);
+			inSample = false;
+		}
+		else if (isBlank(line[0]) == false)
+		{
+			if (inSample)
+				addStack(frames);
+			// The command name is the root of the stacks of a process
+			frames.clear();
+			frames.push_back(parseCommandName(line));
+			inSample = true;
+		}
+		else if (inSample)
+		{
+			const std::string symbol = parseFrame(line);
+			if (symbol.empty() == false)
+				frames.push_back(symbol);
+		}
+	}
+
+	if (inSample)
+		addStack(frames);
+
+	return true;
+}
+
+bool FlameGraph::writeFolded(const char *filename) const
+{
+	std::ofstream file(filename, std::ios::trunc);
+	if (file.is_open() == false)
+		return false;
+
+	for (const auto &pair : stacks_)
+		file << pair.first << " " << pair.second << "\n";
+
+	return file.good();
+}
+
+bool FlameGraph::writeSvg(const char *filename, const char *title) const
+{
+	std::ofstream file(filename, std::ios::trunc);
+	if (file.is_open() == false)
+		return false;
+
+	std::vector<Node> nodes;
+	buildTree(nodes);
+
+	struct Frame
+	{
+		unsigned int node;
+		unsigned int depth;
+		float x;
+		float width;
+	};
+
+	// Visits the tree to place the frames that are wide enough to be drawn
+	const float pixelsPerSample = (numSamples_ > 0) ? (ImageWidth - 2 * Padding) / static_cast<float>(numSamples_) : 0.0f;
+	std::vector<Frame> frames;
+	std::vector<Frame> pending;
+	pending.push_back({ 0, 0, static_cast<float>(Padding), nodes[0].samples * pixelsPerSample });
+	unsigned int maxDepth = 0;
+	while (pending.empty() == false)
+	{
+		const Frame frame = pending.back();
+		pending.pop_back();
+		frames.push_back(frame);
+		maxDepth = std::max(maxDepth, frame.depth);
+
+		float x = frame.x;
+		for (const auto &child : nodes[frame.node].children)
+		{
+			const float width = nodes[child.second].samples * pixelsPerSample;
+			if (width >= MinFrameWidth)
+				pending.push_back({ child.second, frame.depth + 1, x, width });
+			x += width;
+		}
+	}
+
+	const unsigned int imageHeight = TitleHeight + (maxDepth + 1) * FrameHeight + 2 * Padding;
+	file << "<?xml version=\"1.0\" standalone=\"no\"?>\n";
+	file << "<svg version=\"1.1\" width=\"" << ImageWidth << "\" height=\"" << imageHeight << "\" viewBox=\"0 0 " << ImageWidth << " " << imageHeight
+	     << "\" xmlns=\"http://www.w3.org/2000/svg\" font-family=\"Verdana, sans-serif\" font-size=\"" << FontSize << "\">\n";
+	file << "<rect x=\"0\" y=\"0\" width=\"100%\" height=\"100%\" fill=\"#f8f8f8\"/>\n";
+	file << "<text x=\"" << ImageWidth / 2 << "\" y=\"" << Padding + FontSize << "\" text-anchor=\"middle\" font-size=\"" << FontSize + 5 << "\">"
+	     << Helpers::escapeXml(title) << "</text>\n";
+
+	const int MaxLength = 64;
+	char buffer[MaxLength];
+	for (const Frame &frame : frames)
+	{
+		const Node &node = nodes[frame.node];
+		const unsigned int y = imageHeight - Padding - (frame.depth + 1) * FrameHeight;
+		unsigned int red, green, blue;
+		frameColor(node.name, red, green, blue);
+
+		snprintf(buffer, MaxLength, "%lu samples, %.2f%%", node.samples, 100.0f * node.samples / numSamples_);
+		file << "<g><title>" << Helpers::escapeXml(node.name) << " (" << buffer << ")</title>";
+		snprintf(buffer, MaxLength, "x=\"%.1f\" y=\"%u\" width=\"%.1f\" height=\"%u\"", frame.x, y, frame.width, FrameHeight - 1);
+		file << "<rect " << buffer << " fill=\"rgb(" << red << "," << green << "," << blue << ")\" rx=\"2\"/>";
+
+		// Names are truncated to the width of their frame
+		const unsigned int numChars = static_cast<unsigned int>((frame.width - 6.0f) / (FontSize * CharWidthRatio));
+		if (numChars >= 3)
+		{
+			const std::string label = (node.name.size() <= numChars) ? node.name : node.name.substr(0, numChars - 2) + "..";
+			snprintf(buffer, MaxLength, "x=\"%.1f\" y=\"%.1f\"", frame.x + 3.0f, y + FrameHeight - 4.5f);
+			file << "<text " << buffer << ">" << Helpers::escapeXml(label) << "</text>";
+		}
+		file << "</g>\n";
+	}
+	file << "</svg>\n";
+
+	return file.good();
+}
+
+void FlameGraph::printHottest(unsigned int numEntries) const
+{
+	if (numSamples_ == 0)
+		return;
+
+	std::map<std::string, unsigned long> selfSamples;
+	for (const auto &pair : stacks_)
+	{
+		const size_t separator = pair.first.rfind(';');
+		selfSamples[(separator == std::string::npos) ? pair.first : pair.first.substr(separator + 1)] += pair.second;
+	}
+
+	std::vector<std::pair<std::string, unsigned long>> functions(selfSamples.begin(), selfSamples.end());
+	std::sort(functions.begin(), functions.end(), [](const std::pair<std::string, unsigned long> &a, const std::pair<std::string, unsigned long> &b) {
+		return (a.second != b.second) ? a.second > b.second : a.first < b.first;
+	});
+	if (functions.size() > numEntries)
+		functions.resize(numEntries);
+
+	const int MaxLength = 512;
+	char buffer[MaxLength];
+	Helpers::info("Hottest functions by samples at the top of the stack:");
+	for (const auto &function : functions)
+	{
+		snprintf(buffer, MaxLength, "%7.2f%%  %8lu  %s", 100.0f * function.second / numSamples_, function.second, function.first.data());
+		std::cout << buffer << "\n";
+	}
+	std::cout << std::flush;
+}
+
+///////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+///////////////////////////////////////////////////////////
+
+void FlameGraph::addStack(const std::vector<std::string> &frames)
+{
+	// The frames after the command name are listed from the leaf to the root
+	std::string stack = frames.empty() ? std::string("[unknown]") : frames[0];
+	for (size_t i = frames.size(); i > 1; i--)
+		stack += ";" + frames[i - 1];
+
+	stacks_[stack]++;
+	numSamples_++;
+}
+
+void FlameGraph::buildTree(std::vector<Node> &nodes) const
+{
+	nodes.clear();
+	nodes.emplace_back();
+	nodes[0].name = "all";
+	nodes[0].samples = numSamples_;
+
+	for (const auto &pair : stacks_)
+	{
+		unsigned int parent = 0;
+		size_t start = 0;
+		while (start <= pair.first.size())
+		{
+			size_t end = pair.first.find(';', start);
+			if (end == std::string::npos)
+				end = pair.first.size();
+			const std::string name = pair.first.substr(start, end - start);
+
+			// The vector can grow, only indices are kept across insertions
+			auto childIt = nodes[parent].children.find(name);
+			unsigned int child = 0;
+			if (childIt == nodes[parent].children.end())
+			{
+				child = static_cast<unsigned int>(nodes.size());
+				nodes[parent].children[name] = child;
+				nodes.emplace_back();
+				nodes[child].name = name;
+			}
+			else
+				child = childIt->second;
+
+			nodes[child].samples += pair.second;
+			parent = child;
+			start = end + 1;
+		}
+	}
+}
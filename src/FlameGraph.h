@@ -0,0 +1,38 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+
+/// The call stacks sampled by `perf`, folded and drawn as a flame graph
+class FlameGraph
+{
+  public:
+	/// Folds the call stacks of the samples printed by `perf script`
+	bool addPerfScript(const char *filename);
+
+	/// Writes every distinct call stack on a line, from the root to the leaf separated by semicolons, followed by its samples
+	bool writeFolded(const char *filename) const;
+	/// Writes a standalone SVG image with a tooltip for every frame
+	bool writeSvg(const char *filename, const char *title) const;
+
+	inline unsigned long numSamples() const { return numSamples_; }
+	/// Prints the functions with the most samples at the top of the stack
+	void printHottest(unsigned int numEntries) const;
+
+  private:
+	struct Node
+	{
+		std::string name;
+		unsigned long samples = 0;
+		/// Indices of the callees, sorted by name
+		std::map<std::string, unsigned int> children;
+	};
+
+	/// The number of samples of every folded call stack
+	std::map<std::string, unsigned long> stacks_;
+	unsigned long numSamples_ = 0;
+
+	void addStack(const std::vector<std::string> &frames);
+	void buildTree(std::vector<Node> &nodes) const;
+};
@@ -112,6 +112,69 @@ bool GitCommand::checkout(const char *repositoryDir, const char *branch, const c
 	return executed;
 }
 
+bool GitCommand::retrieveHead(const char *repositoryDir, std::string &hash)
+{
+	assert(repositoryDir);
+
+	const std::string repositoryGitDir = fs::joinPath(repositoryDir, ".git");
+	if (found_ == false || fs::isDirectory(repositoryGitDir.data()) == false)
+		return false;
+
+	snprintf(buffer, MaxLength, "%s --git-dir=%s rev-parse --short HEAD %s", executable_.data(), repositoryGitDir.data(), Helpers::redirectErrorsToNull());
+	const bool executed = Process::executeCommand(buffer, output_, Process::Echo::DISABLED, Process::OverrideDryRun::ENABLED);
+	if (executed)
+	{
+		hash = output_;
+		hash.erase(std::remove(hash.begin(), hash.end(), '\n'), hash.end());
+		hash.erase(std::remove(hash.begin(), hash.end(), '\r'), hash.end());
+	}
+
+	return (executed && hash.empty() == false);
+}
+
+bool GitCommand::hasLocalChanges(const char *repositoryDir)
+{
+	assert(found_);
+	assert(repositoryDir);
+
+	const std::string repositoryGitDir = fs::joinPath(repositoryDir, ".git");
+	snprintf(buffer, MaxLength, "%s --git-dir=%s --work-tree=%s status --porcelain --untracked-files=no", executable_.data(), repositoryGitDir.data(), repositoryDir);
+	const bool executed = Process::executeCommand(buffer, output_, Process::Echo::DISABLED, Process::OverrideDryRun::ENABLED);
+
+	return (executed == false || output_.empty() == false);
+}
+
+bool GitCommand::retrieveChangedFiles(const char *repositoryDir, const char *commit, std::vector<std::string> &files)
+{
+	assert(found_);
+	assert(repositoryDir);
+	assert(commit);
+
+	const std::string repositoryGitDir = fs::joinPath(repositoryDir, ".git");
+	snprintf(buffer, MaxLength, "%s --git-dir=\"%s\" --work-tree=\"%s\" diff --name-only %s %s", executable_.data(), repositoryGitDir.data(), repositoryDir, commit, Helpers::redirectErrorsToNull());
+	const bool executed = Process::executeCommand(buffer, output_, Process::Echo::DISABLED, Process::OverrideDryRun::ENABLED);
+	if (executed == false)
+		return false;
+
+	files.clear();
+	size_t start = 0;
+	while (start < output_.size())
+	{
+		size_t end = output_.find('\n', start);
+		if (end == std::string::npos)
+			end = output_.size();
+
+		std::string file = output_.substr(start, end - start);
+		if (file.empty() == false && file.back() == '\r')
+			file.pop_back();
+		if (file.empty() == false)
+			files.push_back(file);
+		start = end + 1;
+	}
+
+	return true;
+}
+
 bool GitCommand::checkRepositoryVersion(const char *repositoryDir, std::string &version)
 {
 	const std::string repositoryGitDir = fs::joinPath(repositoryDir, ".git");
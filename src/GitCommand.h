@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 class GitCommand
 {
@@ -16,6 +17,12 @@ class GitCommand
 	bool checkout(const char *repositoryDir, const char *branch, const char *workTreeDir);
 	inline bool checkout(const char *repositoryDir, const char *branch) { return checkout(repositoryDir, branch, repositoryDir); }
 	bool checkRepositoryVersion(const char *repositoryDir, std::string &version);
+	/// Retrieves the abbreviated hash of the commit checked out in a repository
+	bool retrieveHead(const char *repositoryDir, std::string &hash);
+	/// Returns true if tracked files of a repository have been modified
+	bool hasLocalChanges(const char *repositoryDir);
+	/// Retrieves the paths, relative to the repository, of the tracked files that differ from a commit, including local changes
+	bool retrieveChangedFiles(const char *repositoryDir, const char *commit, std::vector<std::string> &files);
 
 	inline bool found() const { return found_; }
 	inline const std::string &executable() const { return executable_; }
@@ -28,6 +28,9 @@ const char *Cyan = "\033[36m";
 const char *Blue = "\033[94m";
 const char *EndColor = "\033[0m";
 
+/// The stream the messages of a thread are printed to
+thread_local std::ostream *outputStream = &std::cout;
+
 }
 
 ///////////////////////////////////////////////////////////
@@ -38,7 +41,7 @@ const char *Helpers::getEnvironment(const char *name)
 {
 #ifdef _WIN32
 	const int MaxLength = 2048;
-	static char buffer[MaxLength];
+	thread_local static char buffer[MaxLength];
 	const DWORD numChars = GetEnvironmentVariable(name, buffer, MaxLength);
 	if (numChars == 0 || numChars > MaxLength)
 		return nullptr;
@@ -124,68 +127,130 @@ const char *Helpers::redirectErrorsToNull()
 #endif
 }
 
+std::string Helpers::trim(const std::string &string)
+{
+	const size_t first = string.find_first_not_of(" \t\r\n");
+	if (first == std::string::npos)
+		return std::string();
+	const size_t last = string.find_last_not_of(" \t\r\n");
+	return string.substr(first, last - first + 1);
+}
+
+std::string Helpers::escapeXml(const std::string &string)
+{
+	std::string escaped;
+	for (const char c : string)
+	{
+		switch (c)
+		{
+			case '&': escaped += "&amp;"; break;
+			case '<': escaped += "&lt;"; break;
+			case '>': escaped += "&gt;"; break;
+			case '"': escaped += "&quot;"; break;
+			case '\'': escaped += "&apos;"; break;
+			default: escaped += c; break;
+		}
+	}
+	return escaped;
+}
+
+void Helpers::redirectOutput(std::ostream *stream)
+{
+	outputStream = (stream != nullptr) ? stream : &std::cout;
+}
+
+std::ostream &Helpers::output()
+{
+	return *outputStream;
+}
+
 void Helpers::echo(const char *msg)
 {
-	std::cout << ":: " << msg << "\n" << std::flush;
+	*outputStream << ":: " << msg << "\n" << std::flush;
 }
 
 void Helpers::info(const char *msg)
 {
-	std::cout << "-> ";
+	*outputStream << "-> ";
 
 	if (config().withColors())
-		std::cout << Blue;
-	std::cout << msg;
+		*outputStream << Blue;
+	*outputStream << msg;
 	if (config().withColors())
-		std::cout << EndColor;
+		*outputStream << EndColor;
 
-	std::cout << "\n";
+	*outputStream << "\n";
 }
 
 void Helpers::info(const char *msg1, const char *msg2)
 {
-	std::cout << "-> ";
+	*outputStream << "-> ";
 
 	if (config().withColors())
-		std::cout << Blue;
-	std::cout << msg1;
+		*outputStream << Blue;
+	*outputStream << msg1;
 	if (config().withColors())
-		std::cout << EndColor;
+		*outputStream << EndColor;
 
-	std::cout << msg2 << "\n";
+	*outputStream << msg2 << "\n";
 }
 
 void Helpers::error(const char *msg)
 {
-	std::cout << "!! ";
+	*outputStream << "!! ";
 
 	if (config().withColors())
-		std::cout << Red;
-	std::cout << msg;
+		*outputStream << Red;
+	*outputStream << msg;
 	if (config().withColors())
-		std::cout << EndColor;
+		*outputStream << EndColor;
 
-	std::cout << "\n";
+	*outputStream << "\n";
 }
 
 void Helpers::error(const char *msg1, const char *msg2)
 {
-	std::cout << "!! ";
+	*outputStream << "!! ";
 
 	if (config().withColors())
-		std::cout << Red;
-	std::cout << msg1;
+		*outputStream << Red;
+	*outputStream << msg1;
 	if (config().withColors())
-		std::cout << EndColor;
+		*outputStream << EndColor;
 
-	std::cout << msg2 << "\n";
+	*outputStream << msg2 << "\n";
 }
 
-void Helpers::buildDir(std::string &binaryDir)
+void Helpers::buildDir(std::string &binaryDir, const Settings &settings)
 {
 	if (config().platform() == Configuration::Platform::EMSCRIPTEN)
 		binaryDir += "-web";
 
+	// The build type is chosen at configuration time by single configuration generators
+	const bool singleConfig = (CMakeCommand::generatorIsMultiConfig() == false || config().platform() == Configuration::Platform::ANDROID);
+	switch (settings.buildType())
+	{
+		case Settings::BuildType::DEBUG:
+			if (singleConfig)
+				binaryDir += "-debug";
+			break;
+		case Settings::BuildType::RELEASE:
+			// The default build type keeps the directory name used by previous versions
+			break;
+		case Settings::BuildType::RELWITHDEBINFO:
+			if (singleConfig)
+				binaryDir += "-relwithdebinfo";
+			break;
+		case Settings::BuildType::MINSIZEREL:
+			if (singleConfig)
+				binaryDir += "-minsizerel";
+			break;
+		case Settings::BuildType::PROFILE:
+			// Profiling compiler flags are set at configuration time even for multi-configuration generators
+			binaryDir += "-profile";
+			break;
+	}
+
 	binaryDir += "-build";
 }
 
@@ -200,6 +265,30 @@ void Helpers::distDir(std::string &binaryDir, const Settings &settings)
 		binaryDir += "-BinDist";
 }
 
+std::string Helpers::targetBuildDir(const Settings &settings)
+{
+	std::string binaryDir;
+
+	switch (settings.target())
+	{
+		case Settings::Target::LIBS:
+			if (config().platform() == Configuration::Platform::ANDROID)
+				binaryDir = nCineAndroidLibrariesSourceDir();
+			else
+				binaryDir = nCineLibrariesSourceDir();
+			break;
+		case Settings::Target::ENGINE:
+			binaryDir = nCineSourceDir();
+			break;
+		case Settings::Target::GAME:
+			config().gameName(binaryDir);
+			break;
+	}
+
+	buildDir(binaryDir, settings);
+	return binaryDir;
+}
+
 std::string Helpers::gameRepositoryUrl(const std::string &gameName)
 {
 	assert(gameName.empty() == false);
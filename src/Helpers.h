@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <iosfwd>
 
 class Settings;
 
@@ -20,14 +21,26 @@ class Helpers
 #endif
 	static const char *redirectErrorsToNull();
 
+	/// Removes the spaces, tabs and line endings at both ends of a string
+	static std::string trim(const std::string &string);
+	/// Replaces the characters that have a special meaning in XML with their entities
+	static std::string escapeXml(const std::string &string);
+
+	/// Redirects the messages printed by the calling thread to a stream, or back to the standard output if null
+	static void redirectOutput(std::ostream *stream);
+	/// Returns the stream the messages of the calling thread are printed to
+	static std::ostream &output();
+
 	static void echo(const char *msg);
 	static void info(const char *msg);
 	static void info(const char *msg1, const char *msg2);
 	static void error(const char *msg);
 	static void error(const char *msg1, const char *msg2);
 
-	static void buildDir(std::string &binaryDir);
+	static void buildDir(std::string &binaryDir, const Settings &settings);
 	static void distDir(std::string &binaryDir, const Settings &settings);
+	/// Returns the build directory of the target and build type chosen in the settings
+	static std::string targetBuildDir(const Settings &settings);
 
 	static const char *nCineLibrariesRepositoryUrl() { return "https://github.com/nCine/nCine-libraries.git"; }
 	static const char *nCineAndroidLibrariesRepositoryUrl() { return "https://github.com/nCine/nCine-android-libraries.git"; }
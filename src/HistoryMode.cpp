@@ -0,0 +1,24 @@
+#include <cassert>
+#include "HistoryMode.h"
+#include "BuildHistory.h"
+#include "Settings.h"
+#include "Configuration.h"
+#include "Helpers.h"
+
+///////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////
+
+void HistoryMode::perform(const Settings &settings)
+{
+	assert(settings.mode() == Settings::Mode::HISTORY);
+
+	BuildHistory history;
+	if (history.load() == false)
+	{
+		Helpers::error("Cannot read the build history: ", BuildHistory::historyFile());
+		return;
+	}
+
+	history.printReport(Settings::targetToString(settings.target()), settings.reportEntries(), config().regressionThreshold());
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+class Settings;
+
+class HistoryMode
+{
+  public:
+	static void perform(const Settings &settings);
+};
@@ -0,0 +1,196 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <thread>
+#include "JobCount.h"
+#include "Configuration.h"
+#include "Helpers.h"
+
+#ifdef __linux__
+	#include <sched.h>
+#endif
+
+namespace {
+
+#ifdef __linux__
+/// Returns the directory of the cgroup v2 hierarchy the process belongs to
+std::string cgroupDir()
+{
+	std::string cgroupDir = "/sys/fs/cgroup";
+
+	std::ifstream file("/proc/self/cgroup");
+	std::string line;
+	while (std::getline(file, line))
+	{
+		// The unified hierarchy entry has the form `0::/path`
+		if (line.compare(0, 3, "0::") == 0 && line.length() > 4)
+		{
+			cgroupDir += line.substr(3);
+			break;
+		}
+	}
+
+	return cgroupDir;
+}
+
+bool readFirstLine(const std::string &filename, std::string &line)
+{
+	std::ifstream file(filename.data());
+	return (file.is_open() && std::getline(file, line));
+}
+
+/// Returns the limit in bytes of a cgroup memory file, or zero if there is no limit
+unsigned long long readMemoryValue(const std::string &filename)
+{
+	std::string line;
+	if (readFirstLine(filename, line) == false || line == "max")
+		return 0;
+	return strtoull(line.data(), nullptr, 10);
+}
+#endif
+
+}
+
+///////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////
+
+unsigned int JobCount::compute(unsigned int override, std::string &reason)
+{
+	const int MaxLength = 256;
+	char buffer[MaxLength];
+
+	if (override > 0)
+	{
+		reason = "specified on the command line";
+		return override;
+	}
+
+	unsigned int jobs = availableCpus(reason);
+
+	std::string memoryReason;
+	unsigned long memory = 0;
+	const bool memoryKnown = availableMemory(memory, memoryReason);
+	const unsigned int jobMemory = config().jobMemory();
+	if (memoryKnown && jobMemory > 0)
+	{
+		// An exhausted memory budget still allows one job
+		unsigned int memoryJobs = static_cast<unsigned int>(memory / jobMemory);
+		if (memoryJobs == 0)
+			memoryJobs = 1;
+		if (memoryJobs < jobs)
+		{
+			jobs = memoryJobs;
+			snprintf(buffer, MaxLength, "%s, %lu MB for %u MB per job", memoryReason.data(), memory, jobMemory);
+			reason = buffer;
+		}
+	}
+
+	if (jobs == 0)
+		jobs = 1;
+
+	return jobs;
+}
+
+void JobCount::print(unsigned int jobs, const std::string &reason)
+{
+	const int MaxLength = 256;
+	char buffer[MaxLength];
+	snprintf(buffer, MaxLength, "%u (%s)", jobs, reason.data());
+	Helpers::info("Number of parallel build jobs: ", buffer);
+}
+
+unsigned int JobCount::availableCpus(std::string &reason)
+{
+	unsigned int cpus = std::thread::hardware_concurrency();
+	reason = "hardware threads";
+	if (cpus == 0)
+	{
+		cpus = 1;
+		reason = "unknown hardware threads";
+	}
+
+#ifdef __linux__
+	cpu_set_t cpuSet;
+	if (sched_getaffinity(0, sizeof(cpuSet), &cpuSet) == 0)
+	{
+		const unsigned int affinityCpus = CPU_COUNT(&cpuSet);
+		if (affinityCpus > 0 && affinityCpus < cpus)
+		{
+			cpus = affinityCpus;
+			reason = "CPU affinity mask";
+		}
+	}
+
+	// The `cpu.max` file contains the quota and the period, or `max` if there is no quota
+	std::string line;
+	if (readFirstLine(cgroupDir() + "/cpu.max", line) && line.compare(0, 3, "max") != 0)
+	{
+		unsigned long quota = 0;
+		unsigned long period = 0;
+		if (sscanf(line.data(), "%lu %lu", &quota, &period) == 2 && quota > 0 && period > 0)
+		{
+			const unsigned int quotaCpus = static_cast<unsigned int>((quota + period - 1) / period);
+			if (quotaCpus < cpus)
+			{
+				cpus = quotaCpus;
+				reason = "cgroup CPU quota";
+			}
+		}
+	}
+#endif
+
+	return cpus;
+}
+
+bool JobCount::availableMemory(unsigned long &memory, std::string &reason)
+{
+	bool memoryKnown = false;
+	memory = 0;
+
+#ifdef __linux__
+	std::ifstream file("/proc/meminfo");
+	std::string line;
+	while (std::getline(file, line))
+	{
+		unsigned long kilobytes = 0;
+		if (sscanf(line.data(), "MemAvailable: %lu kB", &kilobytes) == 1)
+		{
+			memory = kilobytes / 1024;
+			memoryKnown = true;
+			reason = "available memory";
+			break;
+		}
+	}
+
+	const std::string dir = cgroupDir();
+	const unsigned long long limit = readMemoryValue(dir + "/memory.max");
+	if (limit > 0)
+	{
+		unsigned long long current = readMemoryValue(dir + "/memory.current");
+
+		// Inactive page cache is reclaimed by the kernel before the limit is hit
+		std::ifstream statFile((dir + "/memory.stat").data());
+		while (std::getline(statFile, line))
+		{
+			unsigned long long inactiveFile = 0;
+			if (sscanf(line.data(), "inactive_file %llu", &inactiveFile) == 1)
+			{
+				current = (current > inactiveFile) ? current - inactiveFile : 0;
+				break;
+			}
+		}
+
+		const unsigned long cgroupMemory = (limit > current) ? static_cast<unsigned long>((limit - current) / (1024 * 1024)) : 0;
+		if (memoryKnown == false || cgroupMemory < memory)
+		{
+			memory = cgroupMemory;
+			memoryKnown = true;
+			reason = "cgroup memory limit";
+		}
+	}
+#endif
+
+	return memoryKnown;
+}
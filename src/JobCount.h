@@ -0,0 +1,18 @@
+#pragma once
+
+#include <string>
+
+/// The number of parallel build jobs allowed by the available CPUs and memory
+class JobCount
+{
+  public:
+	/// Returns the number of jobs and a description of the limiting factor
+	static unsigned int compute(unsigned int override, std::string &reason);
+	/// Prints the number of jobs with the description of the limiting factor
+	static void print(unsigned int jobs, const std::string &reason);
+
+	static unsigned int availableCpus(std::string &reason);
+	/// Retrieves the available memory in megabytes, which can be zero if it is exhausted
+	/// \return False if the available memory cannot be retrieved
+	static bool availableMemory(unsigned long &memory, std::string &reason);
+};
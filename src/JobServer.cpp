@@ -0,0 +1,186 @@
+#include <cstdio>
+#include <vector>
+#include "JobServer.h"
+#include "CMakeCommand.h"
+#include "Process.h"
+#include "FileSystem.h"
+#include "Configuration.h"
+#include "Helpers.h"
+
+#ifndef _WIN32
+	#include <fcntl.h>
+	#include <unistd.h>
+	#include <sys/stat.h>
+#endif
+
+namespace {
+
+/// Returns true if GNU make understands the FIFO style jobserver authentication, introduced with version 4.4
+bool makeSupportsFifo()
+{
+	std::string output;
+	unsigned int version[2] = { 0, 0 };
+	const bool executed = Process::executeCommand("make --version", output, Process::Echo::DISABLED, Process::OverrideDryRun::ENABLED);
+	if (executed && sscanf(output.data(), "GNU Make %u.%u", &version[0], &version[1]) == 2)
+		return Helpers::checkMinVersion(version[0], version[1], 0, 4, 4, 0);
+	return false;
+}
+
+}
+
+///////////////////////////////////////////////////////////
+// CONSTRUCTORS and DESTRUCTOR
+///////////////////////////////////////////////////////////
+
+JobServer::JobServer()
+    : readFd_(-1), writeFd_(-1)
+{
+}
+
+JobServer::~JobServer()
+{
+	stop();
+}
+
+///////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////
+
+bool JobServer::start(unsigned int jobs)
+{
+#ifdef _WIN32
+	Helpers::error("The jobserver is not supported on Windows");
+	return false;
+#else
+	if (isRunning() || jobs == 0)
+		return false;
+
+	// Older versions of GNU make would stop with an error when finding a FIFO
+	if (makeSupportsFifo())
+		return startFifo(jobs);
+	else
+		return startPipe(jobs);
+#endif
+}
+
+bool JobServer::start(CMakeCommand &cmake)
+{
+	if (config().withJobServer() == false || Process::dryRun)
+		return false;
+
+	if (start(cmake.jobs()) == false)
+		return false;
+
+	Helpers::info("Nested builds share the jobserver slots exported in MAKEFLAGS");
+	// The outer build tool joins the jobserver instead of creating its own pool
+	if (cmake.supportsJobServer(isFifo()))
+		cmake.setJobs(0);
+
+	return true;
+}
+
+///////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+///////////////////////////////////////////////////////////
+
+bool JobServer::startFifo(unsigned int jobs)
+{
+#ifndef _WIN32
+	const char *tempDir = Helpers::getEnvironment("TMPDIR");
+	const int MaxLength = 256;
+	char buffer[MaxLength];
+	snprintf(buffer, MaxLength, "ncline-jobserver-%d", static_cast<int>(getpid()));
+	fifoPath_ = fs::joinPath(tempDir ? tempDir : "/tmp", buffer);
+
+	if (mkfifo(fifoPath_.data(), 0600) != 0)
+	{
+		Helpers::error("Cannot create the jobserver FIFO: ", fifoPath_.data());
+		fifoPath_.clear();
+		return false;
+	}
+
+	// Opening for both reading and writing never blocks and keeps the tokens alive between clients
+	readFd_ = open(fifoPath_.data(), O_RDWR);
+	writeFd_ = readFd_;
+	if (readFd_ < 0)
+	{
+		Helpers::error("Cannot open the jobserver FIFO: ", fifoPath_.data());
+		stop();
+		return false;
+	}
+
+	if (writeTokens(jobs) == false)
+		return false;
+
+	// The FIFO style authentication is understood by GNU make 4.4 and Ninja 1.13
+	snprintf(buffer, MaxLength, " -j%u --jobserver-auth=fifo:%s", jobs, fifoPath_.data());
+	Helpers::setEnvironment("MAKEFLAGS", buffer);
+
+	return true;
+#else
+	return false;
+#endif
+}
+
+bool JobServer::startPipe(unsigned int jobs)
+{
+#ifndef _WIN32
+	// The descriptors are inherited by the child processes
+	int fds[2];
+	if (pipe(fds) != 0)
+	{
+		Helpers::error("Cannot create the jobserver pipe");
+		return false;
+	}
+	readFd_ = fds[0];
+	writeFd_ = fds[1];
+
+	if (writeTokens(jobs) == false)
+		return false;
+
+	// Older GNU make versions only understand the `--jobserver-fds` option
+	const int MaxLength = 256;
+	char buffer[MaxLength];
+	snprintf(buffer, MaxLength, " -j%u --jobserver-fds=%d,%d --jobserver-auth=%d,%d", jobs, readFd_, writeFd_, readFd_, writeFd_);
+	Helpers::setEnvironment("MAKEFLAGS", buffer);
+
+	return true;
+#else
+	return false;
+#endif
+}
+
+bool JobServer::writeTokens(unsigned int jobs)
+{
+#ifndef _WIN32
+	// Every client owns an implicit slot, the jobserver holds the remaining ones
+	const std::vector<char> tokens(jobs - 1, '+');
+	if (tokens.empty() == false && write(writeFd_, tokens.data(), tokens.size()) != static_cast<ssize_t>(tokens.size()))
+	{
+		Helpers::error("Cannot write the jobserver tokens");
+		stop();
+		return false;
+	}
+	return true;
+#else
+	return false;
+#endif
+}
+
+void JobServer::stop()
+{
+#ifndef _WIN32
+	if (readFd_ >= 0)
+		close(readFd_);
+	if (writeFd_ >= 0 && writeFd_ != readFd_)
+		close(writeFd_);
+	readFd_ = -1;
+	writeFd_ = -1;
+
+	if (fifoPath_.empty() == false)
+	{
+		unlink(fifoPath_.data());
+		fifoPath_.clear();
+	}
+#endif
+}
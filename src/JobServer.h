@@ -0,0 +1,34 @@
+#pragma once
+
+#include <string>
+
+class CMakeCommand;
+
+/// A GNU make jobserver that shares a single pool of job slots among all the nested builds
+class JobServer
+{
+  public:
+	JobServer();
+	~JobServer();
+
+	/// Creates the token FIFO and exports it to child processes through `MAKEFLAGS`
+	bool start(unsigned int jobs);
+	/// Starts the jobserver with the jobs of a CMake command, if enabled in the configuration, and lets its build tool join it
+	bool start(CMakeCommand &cmake);
+	inline bool isRunning() const { return readFd_ >= 0; }
+	/// Returns true if the jobserver uses a named FIFO instead of a pair of inherited pipe descriptors
+	inline bool isFifo() const { return fifoPath_.empty() == false; }
+
+  private:
+	int readFd_;
+	int writeFd_;
+	std::string fifoPath_;
+
+	bool startFifo(unsigned int jobs);
+	bool startPipe(unsigned int jobs);
+	bool writeTokens(unsigned int jobs);
+	void stop();
+
+	JobServer(const JobServer &) = delete;
+	JobServer &operator=(const JobServer &) = delete;
+};
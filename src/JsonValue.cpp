@@ -0,0 +1,287 @@
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include "JsonValue.h"
+
+namespace {
+
+const std::string EmptyString;
+
+}
+
+/// A recursive descent parser that fills a tree of `JsonValue` nodes
+class JsonParser
+{
+  public:
+	explicit JsonParser(const std::string &text)
+	    : text_(text.data()), end_(text.data() + text.length()) {}
+
+	bool parseDocument(JsonValue &root)
+	{
+		if (parseValue(root) == false)
+			return false;
+		skipWhitespace();
+		return (text_ == end_);
+	}
+
+  private:
+	const char *text_;
+	const char *end_;
+
+	void skipWhitespace()
+	{
+		while (text_ < end_ && (*text_ == ' ' || *text_ == '\t' || *text_ == '\n' || *text_ == '\r'))
+			text_++;
+	}
+
+	bool consume(const char *literal)
+	{
+		const size_t length = strlen(literal);
+		if (size_t(end_ - text_) < length || strncmp(text_, literal, length) != 0)
+			return false;
+		text_ += length;
+		return true;
+	}
+
+	bool parseValue(JsonValue &value)
+	{
+		skipWhitespace();
+		if (text_ == end_)
+			return false;
+
+		switch (*text_)
+		{
+			case '{': return parseObject(value);
+			case '[': return parseArray(value);
+			case '"':
+				value.type_ = JsonValue::Type::STRING;
+				return parseString(value.string_);
+			case 't':
+				value.type_ = JsonValue::Type::BOOLEAN;
+				value.boolean_ = true;
+				return consume("true");
+			case 'f':
+				value.type_ = JsonValue::Type::BOOLEAN;
+				value.boolean_ = false;
+				return consume("false");
+			case 'n':
+				value.type_ = JsonValue::Type::NUL;
+				return consume("null");
+			default: return parseNumber(value);
+		}
+	}
+
+	bool parseNumber(JsonValue &value)
+	{
+		char *numberEnd = nullptr;
+		value.number_ = strtod(text_, &numberEnd);
+		if (numberEnd == text_ || numberEnd > end_)
+			return false;
+
+		value.type_ = JsonValue::Type::NUMBER;
+		text_ = numberEnd;
+		return true;
+	}
+
+	void appendUtf8(std::string &string, unsigned long codePoint)
+	{
+		if (codePoint < 0x80)
+			string += char(codePoint);
+		else if (codePoint < 0x800)
+		{
+			string += char(0xC0 | (codePoint >> 6));
+			string += char(0x80 | (codePoint & 0x3F));
+		}
+		else
+		{
+			string += char(0xE0 | (codePoint >> 12));
+			string += char(0x80 | ((codePoint >> 6) & 0x3F));
+			string += char(0x80 | (codePoint & 0x3F));
+		}
+	}
+
+	bool parseString(std::string &string)
+	{
+		assert(*text_ == '"');
+		text_++;
+
+		while (text_ < end_ && *text_ != '"')
+		{
+			if (*text_ == '\\')
+			{
+				if (++text_ == end_)
+					return false;
+
+				switch (*text_)
+				{
+					case 'n': string += '\n'; break;
+					case 't': string += '\t'; break;
+					case 'r': string += '\r'; break;
+					case 'b': string += '\b'; break;
+					case 'f': string += '\f'; break;
+					case 'u':
+					{
+						if (end_ - text_ < 5)
+							return false;
+						char hexDigits[5] = {};
+						memcpy(hexDigits, text_ + 1, 4);
+						appendUtf8(string, strtoul(hexDigits, nullptr, 16));
+						text_ += 4;
+						break;
+					}
+					default: string += *text_; break;
+				}
+			}
+			else
+				string += *text_;
+			text_++;
+		}
+
+		if (text_ == end_)
+			return false;
+		text_++;
+		return true;
+	}
+
+	bool parseArray(JsonValue &value)
+	{
+		value.type_ = JsonValue::Type::ARRAY;
+		text_++;
+
+		skipWhitespace();
+		if (text_ < end_ && *text_ == ']')
+		{
+			text_++;
+			return true;
+		}
+
+		while (text_ < end_)
+		{
+			value.elements_.emplace_back();
+			if (parseValue(value.elements_.back()) == false)
+				return false;
+
+			skipWhitespace();
+			if (text_ < end_ && *text_ == ',')
+				text_++;
+			else if (text_ < end_ && *text_ == ']')
+			{
+				text_++;
+				return true;
+			}
+			else
+				return false;
+		}
+
+		return false;
+	}
+
+	bool parseObject(JsonValue &value)
+	{
+		value.type_ = JsonValue::Type::OBJECT;
+		text_++;
+
+		skipWhitespace();
+		if (text_ < end_ && *text_ == '}')
+		{
+			text_++;
+			return true;
+		}
+
+		while (text_ < end_)
+		{
+			skipWhitespace();
+			if (text_ == end_ || *text_ != '"')
+				return false;
+
+			value.names_.emplace_back();
+			if (parseString(value.names_.back()) == false)
+				return false;
+
+			skipWhitespace();
+			if (text_ == end_ || *text_ != ':')
+				return false;
+			text_++;
+
+			value.elements_.emplace_back();
+			if (parseValue(value.elements_.back()) == false)
+				return false;
+
+			skipWhitespace();
+			if (text_ < end_ && *text_ == ',')
+				text_++;
+			else if (text_ < end_ && *text_ == '}')
+			{
+				text_++;
+				return true;
+			}
+			else
+				return false;
+		}
+
+		return false;
+	}
+};
+
+///////////////////////////////////////////////////////////
+// CONSTRUCTORS and DESTRUCTOR
+///////////////////////////////////////////////////////////
+
+JsonValue::JsonValue()
+    : type_(Type::NUL), boolean_(false), number_(0.0)
+{
+}
+
+///////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////
+
+bool JsonValue::parse(const std::string &text, JsonValue &root)
+{
+	root = JsonValue();
+	JsonParser parser(text);
+	return parser.parseDocument(root);
+}
+
+bool JsonValue::parseFile(const char *filename, JsonValue &root)
+{
+	assert(filename);
+
+	std::ifstream file(filename, std::ios::binary);
+	if (file.is_open() == false)
+		return false;
+
+	std::stringstream stream;
+	stream << file.rdbuf();
+	return parse(stream.str(), root);
+}
+
+const JsonValue *JsonValue::member(const char *name) const
+{
+	assert(name);
+
+	if (type_ != Type::OBJECT)
+		return nullptr;
+
+	for (unsigned int i = 0; i < names_.size(); i++)
+	{
+		if (names_[i] == name)
+			return &elements_[i];
+	}
+
+	return nullptr;
+}
+
+double JsonValue::numberMember(const char *name, double defaultValue) const
+{
+	const JsonValue *value = member(name);
+	return (value && value->isNumber()) ? value->number() : defaultValue;
+}
+
+const std::string &JsonValue::stringMember(const char *name) const
+{
+	const JsonValue *value = member(name);
+	return (value && value->isString()) ? value->string() : EmptyString;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+/// A minimal reader for JSON documents
+class JsonValue
+{
+  public:
+	enum class Type
+	{
+		NUL,
+		BOOLEAN,
+		NUMBER,
+		STRING,
+		ARRAY,
+		OBJECT
+	};
+
+	JsonValue();
+
+	static bool parse(const std::string &text, JsonValue &root);
+	static bool parseFile(const char *filename, JsonValue &root);
+
+	inline Type type() const { return type_; }
+	inline bool isNumber() const { return type_ == Type::NUMBER; }
+	inline bool isString() const { return type_ == Type::STRING; }
+	inline bool isArray() const { return type_ == Type::ARRAY; }
+	inline bool isObject() const { return type_ == Type::OBJECT; }
+
+	inline bool boolean() const { return boolean_; }
+	inline double number() const { return number_; }
+	inline const std::string &string() const { return string_; }
+
+	/// Returns the elements of an array or the values of an object
+	inline const std::vector<JsonValue> &elements() const { return elements_; }
+	/// Returns the value of an object member, or `nullptr` if it does not exist
+	const JsonValue *member(const char *name) const;
+
+	/// Returns the number value of an object member, or the default value if it does not exist
+	double numberMember(const char *name, double defaultValue) const;
+	/// Returns the string value of an object member, or an empty string if it does not exist
+	const std::string &stringMember(const char *name) const;
+
+  private:
+	Type type_;
+	bool boolean_;
+	double number_;
+	std::string string_;
+	std::vector<JsonValue> elements_;
+	std::vector<std::string> names_;
+
+	friend class JsonParser;
+};
@@ -0,0 +1,167 @@
+#include <cassert>
+#include <cstdio>
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+#include "NinjaDeps.h"
+#include "Process.h"
+#include "FileSystem.h"
+#include "Helpers.h"
+
+namespace {
+
+struct HeaderCost
+{
+	std::string header;
+	unsigned int numTargets = 0;
+	/// Sum of the compile times of the dependent translation units, in milliseconds
+	unsigned long int cost = 0;
+};
+
+bool isInside(const std::string &path, const std::string &directory)
+{
+	return (path.size() > directory.size() && path.compare(0, directory.size(), directory) == 0 && path[directory.size()] == '/');
+}
+
+}
+
+///////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////
+
+bool NinjaDeps::load(const std::string &ninjaExecutable, const std::string &buildDir)
+{
+	const int MaxLength = 512;
+	char buffer[MaxLength];
+	snprintf(buffer, MaxLength, "%s -C \"%s\" -t deps", ninjaExecutable.data(), buildDir.data());
+
+	std::string output;
+	if (Process::executeCommand(buffer, output, Process::Echo::DISABLED, Process::OverrideDryRun::ENABLED) == false)
+		return false;
+
+	parse(output, buildDir);
+	return true;
+}
+
+void NinjaDeps::parse(const std::string &output, const std::string &buildDir)
+{
+	const std::string absoluteBuildDir = fs::absolutePath(buildDir.data());
+	absoluteBuildDir_ = fs::normalizePath(absoluteBuildDir);
+
+	targets_.clear();
+	std::istringstream stream(output);
+	std::string line;
+	while (std::getline(stream, line))
+	{
+		if (line.empty() == false && line.back() == '\r')
+			line.pop_back();
+		if (line.empty())
+			continue;
+
+		if (line[0] != ' ' && line[0] != '\t')
+		{
+			// A `target: #deps 2, deps mtime 123 (VALID)` line starts a new translation unit
+			const size_t separator = line.rfind(": #deps ");
+			if (separator == std::string::npos)
+				continue;
+
+			Target target;
+			target.output = line.substr(0, separator);
+			targets_.push_back(target);
+		}
+		else if (targets_.empty() == false)
+		{
+			const size_t start = line.find_first_not_of(" \t");
+			const std::string dependency = line.substr(start);
+			const std::string path = fs::isAbsolute(dependency) ? fs::normalizePath(dependency) : fs::normalizePath(fs::joinPath(absoluteBuildDir, dependency));
+			// A unity source includes other sources, they are dependencies like the headers
+			if (targets_.back().source.empty() && fs::isSourceFile(dependency))
+				targets_.back().source = path;
+			else
+				targets_.back().headers.push_back(path);
+		}
+	}
+}
+
+void NinjaDeps::addAffectedOutputs(std::unordered_set<std::string> &paths) const
+{
+	std::vector<std::string> affectedOutputs;
+	for (const Target &target : targets_)
+	{
+		bool isAffected = (target.source.empty() == false && paths.count(target.source) > 0);
+		for (unsigned int i = 0; i < target.headers.size() && isAffected == false; i++)
+			isAffected = (paths.count(target.headers[i]) > 0);
+
+		if (isAffected)
+			affectedOutputs.push_back(fs::normalizePath(fs::joinPath(absoluteBuildDir_, target.output)));
+	}
+
+	paths.insert(affectedOutputs.begin(), affectedOutputs.end());
+}
+
+void NinjaDeps::printHeaderCosts(const std::unordered_map<std::string, unsigned int> &durations, const std::vector<std::string> &projectDirs, unsigned int numEntries) const
+{
+	std::vector<std::string> normalizedDirs;
+	for (const std::string &projectDir : projectDirs)
+		normalizedDirs.push_back(fs::normalizePath(fs::absolutePath(projectDir.data())));
+
+	std::unordered_map<std::string, HeaderCost> headerCosts;
+	unsigned int numTimedTargets = 0;
+	for (const Target &target : targets_)
+	{
+		auto durationIt = durations.find(target.output);
+		const unsigned int duration = (durationIt != durations.end()) ? durationIt->second : 0;
+		if (durationIt != durations.end())
+			numTimedTargets++;
+
+		for (const std::string &header : target.headers)
+		{
+			auto headerIt = headerCosts.find(header);
+			if (headerIt == headerCosts.end())
+			{
+				bool isProjectHeader = false;
+				for (const std::string &projectDir : normalizedDirs)
+					isProjectHeader = isProjectHeader || isInside(header, projectDir);
+				// System and third-party headers are not touched during development
+				if (isProjectHeader == false)
+					continue;
+
+				headerIt = headerCosts.emplace(header, HeaderCost()).first;
+				headerIt->second.header = header;
+			}
+
+			headerIt->second.numTargets++;
+			headerIt->second.cost += duration;
+		}
+	}
+
+	std::vector<HeaderCost> sortedCosts;
+	sortedCosts.reserve(headerCosts.size());
+	for (const auto &pair : headerCosts)
+		sortedCosts.push_back(pair.second);
+	std::sort(sortedCosts.begin(), sortedCosts.end(), [](const HeaderCost &a, const HeaderCost &b) {
+		return (a.cost != b.cost) ? a.cost > b.cost : a.numTargets > b.numTargets;
+	});
+
+	const int MaxLength = 512;
+	char buffer[MaxLength];
+	snprintf(buffer, MaxLength, "%zu project headers, %u translation units (%u with a recorded compile time)", sortedCosts.size(), numTargets(), numTimedTargets);
+	Helpers::info("Dependencies: ", buffer);
+	if (sortedCosts.empty())
+		return;
+
+	// Headers are shown relative to the directory that contains all the projects
+	const std::string workspaceDir = fs::normalizePath(fs::currentDir());
+	Helpers::info("Compile time to rebuild the translation units that include a header:");
+	for (unsigned int i = 0; i < sortedCosts.size() && i < numEntries; i++)
+	{
+		const HeaderCost &headerCost = sortedCosts[i];
+		const char *header = headerCost.header.data();
+		if (isInside(headerCost.header, workspaceDir))
+			header += workspaceDir.size() + 1;
+
+		snprintf(buffer, MaxLength, "%10.2f s  %5u TUs  %s", headerCost.cost / 1000.0f, headerCost.numTargets, header);
+		std::cout << buffer << "\n";
+	}
+	std::cout << std::flush;
+}
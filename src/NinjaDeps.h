@@ -0,0 +1,36 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+
+/// The sources and headers that Ninja recorded as dependencies of every compiled translation unit
+class NinjaDeps
+{
+  public:
+	/// Reads the dependency database of a build directory with the `ninja -t deps` tool
+	bool load(const std::string &ninjaExecutable, const std::string &buildDir);
+	/// Parses the output of the `ninja -t deps` tool, with dependency paths relative to the build directory
+	void parse(const std::string &output, const std::string &buildDir);
+
+	inline unsigned int numTargets() const { return static_cast<unsigned int>(targets_.size()); }
+
+	/// Adds to a set of normalized absolute paths the outputs of the translation units that depend on one of them
+	void addAffectedOutputs(std::unordered_set<std::string> &paths) const;
+
+	/// Prints the headers whose modification recompiles the most, only considering the ones inside the project directories
+	void printHeaderCosts(const std::unordered_map<std::string, unsigned int> &durations, const std::vector<std::string> &projectDirs, unsigned int numEntries) const;
+
+  private:
+	struct Target
+	{
+		std::string output;
+		/// Normalized absolute paths of the primary source and of the included files, sources of a unity build among them
+		std::string source;
+		std::vector<std::string> headers;
+	};
+
+	std::string absoluteBuildDir_;
+	std::vector<Target> targets_;
+};
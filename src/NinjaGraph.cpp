@@ -0,0 +1,322 @@
+#include <climits>
+#include <fstream>
+#include "NinjaGraph.h"
+#include "FileSystem.h"
+
+namespace {
+
+const unsigned int Unvisited = UINT_MAX;
+const unsigned int Visiting = UINT_MAX - 1;
+const unsigned int NoEdge = UINT_MAX;
+
+/// Reads the next path of a build statement, unescaping `$ `, `$:` and `$$`
+bool nextPath(const std::string &statement, size_t &position, std::string &path)
+{
+	path.clear();
+	while (position < statement.size() && statement[position] == ' ')
+		position++;
+
+	while (position < statement.size())
+	{
+		const char c = statement[position];
+		if (c == '$' && position + 1 < statement.size())
+		{
+			path += statement[position + 1];
+			position += 2;
+			continue;
+		}
+		else if (c == ' ' || c == ':')
+			break;
+
+		path += c;
+		position++;
+	}
+
+	return (path.empty() == false);
+}
+
+bool isBuildStatement(const std::string &line)
+{
+	return (line.compare(0, 6, "build ") == 0);
+}
+
+}
+
+///////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////
+
+std::string NinjaGraph::buildFile(const std::string &buildDir)
+{
+	return fs::joinPath(buildDir, "build.ninja");
+}
+
+bool NinjaGraph::load(const std::string &buildDir)
+{
+	edges_.clear();
+	if (parseFile(buildDir, "build.ninja") == false)
+		return false;
+
+	resolveDependencies();
+	return true;
+}
+
+void NinjaGraph::setDurations(const std::unordered_map<std::string, unsigned int> &durations)
+{
+	for (Edge &edge : edges_)
+	{
+		edge.duration = 0;
+		for (const std::string &output : edge.outputs)
+		{
+			auto it = durations.find(output);
+			if (it != durations.end())
+			{
+				edge.duration = it->second;
+				break;
+			}
+		}
+	}
+}
+
+void NinjaGraph::addAffectedOutputs(const std::string &buildDir, std::unordered_set<std::string> &paths) const
+{
+	// Sources are usually referenced with absolute paths, generated files with paths relative to the build directory
+	const std::string absoluteBuildDir = fs::normalizePath(fs::absolutePath(buildDir.data()));
+	auto absolutePath = [&absoluteBuildDir](const std::string &path) {
+		return fs::isAbsolute(path) ? fs::normalizePath(path) : fs::normalizePath(fs::joinPath(absoluteBuildDir, path));
+	};
+
+	// Outputs can already be in the set, like the objects that depend on a changed header
+	std::vector<bool> affected(edges_.size(), false);
+	for (unsigned int i = 0; i < edges_.size(); i++)
+	{
+		for (const std::string &source : edges_[i].sources)
+			affected[i] = affected[i] || (paths.count(absolutePath(source)) > 0);
+		for (const std::string &output : edges_[i].outputs)
+			affected[i] = affected[i] || (paths.count(absolutePath(output)) > 0);
+	}
+
+	bool changed = true;
+	// Every pass follows at least one more level of dependent edges
+	while (changed)
+	{
+		changed = false;
+		for (unsigned int i = 0; i < edges_.size(); i++)
+		{
+			const Edge &edge = edges_[i];
+			for (unsigned int j = 0; j < edge.numRebuildDependencies && affected[i] == false; j++)
+			{
+				if (affected[edge.dependencies[j]])
+				{
+					affected[i] = true;
+					changed = true;
+				}
+			}
+		}
+	}
+
+	for (unsigned int i = 0; i < edges_.size(); i++)
+	{
+		if (affected[i])
+		{
+			for (const std::string &output : edges_[i].outputs)
+				paths.insert(absolutePath(output));
+		}
+	}
+}
+
+unsigned int NinjaGraph::criticalPath(std::vector<unsigned int> &path) const
+{
+	std::vector<unsigned int> finishTimes;
+	std::vector<unsigned int> predecessors;
+	const unsigned int length = longestPaths(NoEdge, 0, finishTimes, predecessors);
+
+	path.clear();
+	unsigned int lastEdge = NoEdge;
+	for (unsigned int i = 0; i < edges_.size(); i++)
+	{
+		if (lastEdge == NoEdge || finishTimes[i] > finishTimes[lastEdge])
+			lastEdge = i;
+	}
+
+	for (unsigned int edge = lastEdge; edge != NoEdge; edge = predecessors[edge])
+		path.insert(path.begin(), edge);
+
+	return length;
+}
+
+unsigned int NinjaGraph::criticalPathLength(unsigned int editedEdge, unsigned int editedDuration) const
+{
+	std::vector<unsigned int> finishTimes;
+	std::vector<unsigned int> predecessors;
+	return longestPaths(editedEdge, editedDuration, finishTimes, predecessors);
+}
+
+///////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+///////////////////////////////////////////////////////////
+
+bool NinjaGraph::parseFile(const std::string &buildDir, const std::string &filename)
+{
+	// Paths of included files are relative to the build directory, where Ninja runs
+	std::ifstream file(fs::joinPath(buildDir, filename));
+	if (file.is_open() == false)
+		return false;
+
+	std::string line;
+	std::string statement;
+	while (std::getline(file, line))
+	{
+		if (line.empty() == false && line.back() == '\r')
+			line.pop_back();
+
+		// A line ending with an unescaped `$` continues on the next one
+		size_t dollars = 0;
+		while (dollars < line.size() && line[line.size() - 1 - dollars] == '$')
+			dollars++;
+		if (dollars % 2 == 1)
+		{
+			line.pop_back();
+			statement += line;
+			continue;
+		}
+		statement += line;
+
+		if (isBuildStatement(statement))
+			parseBuildStatement(statement);
+		else if (statement.compare(0, 8, "include ") == 0)
+			parseFile(buildDir, statement.substr(8));
+		else if (statement.compare(0, 9, "subninja ") == 0)
+			parseFile(buildDir, statement.substr(9));
+
+		statement.clear();
+	}
+
+	return true;
+}
+
+void NinjaGraph::parseBuildStatement(const std::string &statement)
+{
+	Edge edge;
+	std::string path;
+	size_t position = 6;
+
+	// Explicit and implicit outputs, up to the colon
+	while (nextPath(statement, position, path))
+	{
+		if (path != "|")
+			edge.outputs.push_back(path);
+	}
+	if (position >= statement.size() || edge.outputs.empty())
+		return;
+	position++;
+
+	// The rule name, phony edges only group other targets
+	nextPath(statement, position, path);
+	const bool isPhony = (path == "phony");
+
+	// Explicit, implicit and order-only inputs
+	bool orderOnly = false;
+	while (position < statement.size())
+	{
+		if (nextPath(statement, position, path))
+		{
+			if (path == "||")
+				orderOnly = true;
+			else if (path != "|")
+			{
+				edge.inputs.push_back(path);
+				if (orderOnly == false)
+					edge.numRebuildInputs++;
+			}
+		}
+		else if (position < statement.size() && statement[position] == ':')
+			position++;
+	}
+
+	if (isPhony && edge.inputs.empty())
+		return;
+	edges_.push_back(edge);
+}
+
+void NinjaGraph::resolveDependencies()
+{
+	std::unordered_map<std::string, unsigned int> producers;
+	for (unsigned int i = 0; i < edges_.size(); i++)
+	{
+		for (const std::string &output : edges_[i].outputs)
+			producers[output] = i;
+	}
+
+	for (Edge &edge : edges_)
+	{
+		for (unsigned int i = 0; i < edge.inputs.size(); i++)
+		{
+			const bool isRebuildInput = (i < edge.numRebuildInputs);
+			auto it = producers.find(edge.inputs[i]);
+			if (it != producers.end())
+			{
+				edge.dependencies.push_back(it->second);
+				if (isRebuildInput)
+					edge.numRebuildDependencies++;
+			}
+			else if (isRebuildInput)
+				edge.sources.push_back(edge.inputs[i]);
+		}
+		edge.inputs.clear();
+	}
+}
+
+unsigned int NinjaGraph::longestPaths(unsigned int editedEdge, unsigned int editedDuration, std::vector<unsigned int> &finishTimes, std::vector<unsigned int> &predecessors) const
+{
+	finishTimes.assign(edges_.size(), Unvisited);
+	predecessors.assign(edges_.size(), NoEdge);
+
+	// An iterative depth first visit, as the graph of a big project can be very deep
+	std::vector<std::pair<unsigned int, unsigned int>> stack;
+	unsigned int length = 0;
+	for (unsigned int root = 0; root < edges_.size(); root++)
+	{
+		if (finishTimes[root] != Unvisited)
+			continue;
+
+		finishTimes[root] = Visiting;
+		stack.emplace_back(root, 0);
+		while (stack.empty() == false)
+		{
+			const unsigned int index = stack.back().first;
+			unsigned int &next = stack.back().second;
+			const Edge &edge = edges_[index];
+
+			if (next < edge.dependencies.size())
+			{
+				const unsigned int dependency = edge.dependencies[next++];
+				// An edge that is still on the stack would be a cycle, ninja refuses to build those
+				if (finishTimes[dependency] == Unvisited)
+				{
+					finishTimes[dependency] = Visiting;
+					stack.emplace_back(dependency, 0);
+				}
+				continue;
+			}
+
+			unsigned int startTime = 0;
+			for (unsigned int dependency : edge.dependencies)
+			{
+				if (finishTimes[dependency] < Visiting && finishTimes[dependency] > startTime)
+				{
+					startTime = finishTimes[dependency];
+					predecessors[index] = dependency;
+				}
+			}
+
+			const unsigned int duration = (index == editedEdge) ? editedDuration : edge.duration;
+			finishTimes[index] = startTime + duration;
+			if (finishTimes[index] > length)
+				length = finishTimes[index];
+			stack.pop_back();
+		}
+	}
+
+	return length;
+}
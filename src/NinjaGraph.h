@@ -0,0 +1,53 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+
+/// The graph of build edges declared in a Ninja build file
+class NinjaGraph
+{
+  public:
+	/// Returns the path of the main build file inside a build directory
+	static std::string buildFile(const std::string &buildDir);
+
+	/// Loads the build file of a directory, following its `include` and `subninja` statements
+	bool load(const std::string &buildDir);
+	/// Assigns to every edge the duration of its outputs, in milliseconds
+	void setDurations(const std::unordered_map<std::string, unsigned int> &durations);
+
+	inline unsigned int numEdges() const { return static_cast<unsigned int>(edges_.size()); }
+	inline const std::string &edgeOutput(unsigned int index) const { return edges_[index].outputs.front(); }
+	inline unsigned int edgeDuration(unsigned int index) const { return edges_[index].duration; }
+
+	/// Adds to a set of normalized absolute paths the outputs of the edges that would be rebuilt because of them, following the dependent edges
+	void addAffectedOutputs(const std::string &buildDir, std::unordered_set<std::string> &paths) const;
+
+	/// Returns the length of the longest chain of dependent edges, filling it from the first edge to the last one
+	unsigned int criticalPath(std::vector<unsigned int> &path) const;
+	/// Returns the length of the critical path if the duration of one edge was changed
+	unsigned int criticalPathLength(unsigned int editedEdge, unsigned int editedDuration) const;
+
+  private:
+	struct Edge
+	{
+		std::vector<std::string> outputs;
+		std::vector<std::string> inputs;
+		/// The number of explicit and implicit inputs at the start of the list, the order-only ones do not trigger a rebuild
+		unsigned int numRebuildInputs = 0;
+		/// The explicit and implicit inputs that are not produced by other edges, like sources
+		std::vector<std::string> sources;
+		/// The indices of the edges producing the inputs, starting from the ones that trigger a rebuild
+		std::vector<unsigned int> dependencies;
+		unsigned int numRebuildDependencies = 0;
+		unsigned int duration = 0;
+	};
+
+	std::vector<Edge> edges_;
+
+	bool parseFile(const std::string &buildDir, const std::string &filename);
+	void parseBuildStatement(const std::string &statement);
+	void resolveDependencies();
+	unsigned int longestPaths(unsigned int editedEdge, unsigned int editedDuration, std::vector<unsigned int> &finishTimes, std::vector<unsigned int> &predecessors) const;
+};
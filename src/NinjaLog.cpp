@@ -0,0 +1,182 @@
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include "NinjaLog.h"
+#include "FileSystem.h"
+#include "Helpers.h"
+
+namespace {
+
+struct Record
+{
+	unsigned int start;
+	unsigned int end;
+	std::string output;
+	std::string hash;
+};
+
+/// Parses a `start end mtime output hash` line of the log, separated by tabs
+bool parseRecord(const std::string &line, Record &record)
+{
+	size_t fields[4];
+	size_t position = 0;
+	for (unsigned int i = 0; i < 4; i++)
+	{
+		position = line.find('\t', position);
+		if (position == std::string::npos)
+			return false;
+		fields[i] = position++;
+	}
+
+	record.start = strtoul(line.data(), nullptr, 10);
+	record.end = strtoul(line.data() + fields[0] + 1, nullptr, 10);
+	record.output = line.substr(fields[2] + 1, fields[3] - fields[2] - 1);
+	record.hash = line.substr(fields[3] + 1);
+	return (record.end >= record.start);
+}
+
+NinjaLog::StepKind outputToKind(const std::string &output)
+{
+	if (fs::endsWith(output, ".o") || fs::endsWith(output, ".obj") || fs::endsWith(output, ".gch") || fs::endsWith(output, ".pch"))
+		return NinjaLog::StepKind::COMPILE;
+
+	if (fs::endsWith(output, ".a") || fs::endsWith(output, ".lib") || fs::endsWith(output, ".so") || output.find(".so.") != std::string::npos ||
+	    fs::endsWith(output, ".dylib") || fs::endsWith(output, ".dll") || fs::endsWith(output, ".exe") || fs::endsWith(output, ".wasm") ||
+	    fs::endsWith(output, ".js") || fs::endsWith(output, ".html"))
+		return NinjaLog::StepKind::LINK;
+
+	// Executables have no extension on Unix, while the outputs of custom commands are stamped inside `CMakeFiles`
+	const std::string baseName = fs::baseName(output.data());
+	if (baseName.find('.') == std::string::npos && output.find("CMakeFiles") == std::string::npos)
+		return NinjaLog::StepKind::LINK;
+
+	return NinjaLog::StepKind::OTHER;
+}
+
+}
+
+///////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////
+
+std::string NinjaLog::logFile(const std::string &buildDir)
+{
+	return fs::joinPath(buildDir, ".ninja_log");
+}
+
+bool NinjaLog::load(const char *filename)
+{
+	assert(filename);
+
+	std::ifstream file(filename);
+	if (file.is_open() == false)
+		return false;
+
+	numRecords_ = 0;
+	steps_.clear();
+	wallTime_ = 0;
+	cpuTime_ = 0;
+	linkTime_ = 0;
+	linkOutputs_.clear();
+	durations_.clear();
+
+	std::string line;
+	std::getline(file, line);
+	if (line.compare(0, 13, "# ninja log v") != 0)
+		return false;
+
+	Record record;
+	Record previous;
+	previous.start = 0;
+	previous.end = 0;
+	while (std::getline(file, line))
+	{
+		if (line.empty() || line[0] == '#' || parseRecord(line, record) == false)
+			continue;
+		numRecords_++;
+		// Later records of the same output overwrite the older ones
+		durations_[record.output] = record.end - record.start;
+
+		// Times restart from zero with every run, and records are appended as soon as their edge has finished
+		if (record.end < previous.end)
+			steps_.clear();
+
+		// The additional outputs of a build edge share its times and command hash
+		const bool sameEdge = (steps_.empty() == false && record.start == previous.start &&
+		                       record.end == previous.end && record.hash == previous.hash);
+		if (sameEdge == false)
+		{
+			Step step;
+			step.output = record.output;
+			step.start = record.start;
+			step.end = record.end;
+			step.kind = outputToKind(record.output);
+			steps_.push_back(step);
+		}
+		previous = record;
+	}
+
+	unsigned int firstStart = steps_.empty() ? 0 : steps_.front().start;
+	unsigned int lastEnd = 0;
+	for (const Step &step : steps_)
+	{
+		firstStart = std::min(firstStart, step.start);
+		lastEnd = std::max(lastEnd, step.end);
+		cpuTime_ += step.duration();
+		if (step.kind == StepKind::LINK)
+			linkTime_ += step.duration();
+	}
+	wallTime_ = lastEnd - firstStart;
+
+	for (const auto &pair : durations_)
+	{
+		if (outputToKind(pair.first) == StepKind::LINK)
+			linkOutputs_.push_back(pair.first);
+	}
+
+	std::sort(steps_.begin(), steps_.end(), [](const Step &a, const Step &b) { return a.duration() > b.duration(); });
+
+	return true;
+}
+
+void NinjaLog::printReport(unsigned int numEntries) const
+{
+	const int MaxLength = 256;
+	char buffer[MaxLength];
+
+	const float parallelism = (wallTime_ > 0) ? cpuTime_ / static_cast<float>(wallTime_) : 0.0f;
+	snprintf(buffer, MaxLength, "%zu steps, %.2f s wall time, %.2f s CPU time, %.2fx parallelism",
+	         steps_.size(), wallTime_ / 1000.0f, cpuTime_ / 1000.0f, parallelism);
+	Helpers::info("Last Ninja run: ", buffer);
+
+	Helpers::info("Slowest compile steps:");
+	printSteps(StepKind::COMPILE, numEntries);
+	Helpers::info("Slowest link steps:");
+	printSteps(StepKind::LINK, numEntries);
+	std::cout << std::flush;
+}
+
+///////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+///////////////////////////////////////////////////////////
+
+void NinjaLog::printSteps(StepKind kind, unsigned int numEntries) const
+{
+	const int MaxLength = 512;
+	char buffer[MaxLength];
+
+	unsigned int printed = 0;
+	for (unsigned int i = 0; i < steps_.size() && printed < numEntries; i++)
+	{
+		const Step &step = steps_[i];
+		if (step.kind != kind)
+			continue;
+
+		snprintf(buffer, MaxLength, "%10.2f s  %s", step.duration() / 1000.0f, step.output.data());
+		std::cout << buffer << "\n";
+		printed++;
+	}
+}
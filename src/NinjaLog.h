@@ -0,0 +1,62 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+/// The analysis of the last run recorded in a Ninja build log
+class NinjaLog
+{
+  public:
+	enum class StepKind
+	{
+		COMPILE,
+		LINK,
+		OTHER
+	};
+
+	struct Step
+	{
+		/// The first output of the build edge
+		std::string output;
+		/// Start and end times relative to the beginning of the run, in milliseconds
+		unsigned int start = 0;
+		unsigned int end = 0;
+		StepKind kind = StepKind::OTHER;
+
+		inline unsigned int duration() const { return end - start; }
+	};
+
+	/// Returns the path of the log file inside a build directory
+	static std::string logFile(const std::string &buildDir);
+
+	bool load(const char *filename);
+
+	/// Returns the number of records in the log, across all runs
+	inline unsigned int numRecords() const { return numRecords_; }
+	/// Returns the steps of the last run, sorted from the slowest
+	inline const std::vector<Step> &steps() const { return steps_; }
+	/// Returns the elapsed time of the last run, in milliseconds
+	inline unsigned int wallTime() const { return wallTime_; }
+	/// Returns the sum of all step durations of the last run, in milliseconds
+	inline unsigned long int cpuTime() const { return cpuTime_; }
+	/// Returns the sum of the link step durations of the last run, in milliseconds
+	inline unsigned int linkTime() const { return linkTime_; }
+	/// Returns the outputs of all the link steps, across all runs
+	inline const std::vector<std::string> &linkOutputs() const { return linkOutputs_; }
+	/// Returns the most recent duration of every output, across all runs
+	inline const std::unordered_map<std::string, unsigned int> &durations() const { return durations_; }
+
+	void printReport(unsigned int numEntries) const;
+
+  private:
+	unsigned int numRecords_ = 0;
+	std::vector<Step> steps_;
+	unsigned int wallTime_ = 0;
+	unsigned long int cpuTime_ = 0;
+	unsigned int linkTime_ = 0;
+	std::vector<std::string> linkOutputs_;
+	std::unordered_map<std::string, unsigned int> durations_;
+
+	void printSteps(StepKind kind, unsigned int numEntries) const;
+};
@@ -0,0 +1,282 @@
+#include <cassert>
+#include <fstream>
+#include <vector>
+#include "PgoMode.h"
+#include "ConfMode.h"
+#include "GitCommand.h"
+#include "CMakeCommand.h"
+#include "CacheCommand.h"
+#include "JobCount.h"
+#include "FileSystem.h"
+#include "Settings.h"
+#include "Configuration.h"
+#include "Process.h"
+#include "Helpers.h"
+
+namespace {
+
+/// The directory that keeps a profile for every combination of target, compiler and commits
+const char *profilesDir = "ncline-pgo";
+/// The name of the merged profile written by Clang tools
+const char *clangProfile = "merged.profdata";
+
+enum class Stage
+{
+	GENERATE,
+	USE
+};
+
+/// Apple Clang is the only compiler on macOS
+bool isClang()
+{
+#ifdef __APPLE__
+	return true;
+#else
+	return (config().compiler() == Configuration::Compiler::CLANG);
+#endif
+}
+
+const char *llvmProfdataExecutable()
+{
+#ifdef __APPLE__
+	return "xcrun llvm-profdata";
+#else
+	return "llvm-profdata";
+#endif
+}
+
+bool checkCompiler()
+{
+	if (config().platform() != Configuration::Platform::DESKTOP)
+	{
+		Helpers::error("Profile-guided optimization is only available for the desktop platform");
+		return false;
+	}
+	else if (CMakeCommand::generatorIsVisualStudio())
+	{
+		Helpers::error("Profile-guided optimization is not available with the Visual Studio generators");
+		return false;
+	}
+#ifndef __APPLE__
+	else if (config().compiler() == Configuration::Compiler::UNSPECIFIED)
+	{
+		Helpers::error("Profile-guided optimization needs a known compiler, choose it with the 'set -gcc' or 'set -clang' command");
+		return false;
+	}
+#endif
+
+	return true;
+}
+
+/// Appends the compiler and linker flags of a stage
+void pgoFlags(std::string &compileFlags, std::string &linkFlags, Stage stage, const std::string &rawDir, const std::string &profileDir)
+{
+	if (stage == Stage::GENERATE)
+	{
+		compileFlags = "-fprofile-generate=" + rawDir;
+		linkFlags = compileFlags;
+		// Counters of multithreaded code would otherwise be corrupted
+		if (isClang() == false)
+			compileFlags += " -fprofile-update=atomic";
+	}
+	else if (isClang())
+	{
+		compileFlags = "-fprofile-use=" + fs::joinPath(profileDir, clangProfile);
+		compileFlags += " -Wno-profile-instr-unprofiled -Wno-profile-instr-out-of-date";
+		linkFlags = "-fprofile-use=" + fs::joinPath(profileDir, clangProfile);
+	}
+	else
+	{
+		// A profile of a recent commit is still useful for the functions that did not change
+		compileFlags = "-fprofile-use=" + profileDir + " -Wno-missing-profile -Wno-coverage-mismatch";
+		linkFlags = "-fprofile-use=" + profileDir;
+	}
+}
+
+/// Configures and builds the engine and, for a game target, the game linked to it
+bool configureAndBuild(CMakeCommand &cmake, const CacheCommand &cache, const Settings &settings, Stage stage, const std::string &rawDir, const std::string &profileDir)
+{
+	std::string engineBuildDir = Helpers::nCineSourceDir() + std::string("-pgo");
+	Helpers::buildDir(engineBuildDir, settings);
+
+	// The flags of the stage are added to the ones of the configuration, like debug information or link-time optimization
+	std::string compileFlags;
+	std::string linkFlags;
+	pgoFlags(compileFlags, linkFlags, stage, rawDir, profileDir);
+
+	std::string arguments;
+	ConfMode::engineArguments(arguments, cmake, cache, settings, compileFlags, linkFlags);
+
+	Helpers::info("Configure and build the engine in: ", engineBuildDir.data());
+	const char *buildConfig = CMakeCommand::generatorIsMultiConfig() ? Settings::buildTypeToConfigString(settings.buildType()) : nullptr;
+	if (cmake.configure(Helpers::nCineSourceDir(), engineBuildDir.data(), arguments.data()) == false ||
+	    cmake.build(engineBuildDir.data(), buildConfig, nullptr) == false)
+		return false;
+
+	if (settings.target() == Settings::Target::GAME)
+	{
+		std::string gameName;
+		config().gameName(gameName);
+		std::string gameBuildDir = gameName + "-pgo";
+		Helpers::buildDir(gameBuildDir, settings);
+
+		arguments.clear();
+		ConfMode::gameArguments(arguments, cmake, cache, settings, compileFlags, linkFlags);
+		// The game is linked to the engine of the same stage
+		arguments += " -D nCine_DIR=\"" + fs::joinPath(fs::currentDir(), engineBuildDir) + "\"";
+
+		Helpers::info("Configure and build the game in: ", gameBuildDir.data());
+		if (cmake.configure(gameName.data(), gameBuildDir.data(), arguments.data()) == false ||
+		    cmake.build(gameBuildDir.data(), buildConfig, nullptr) == false)
+			return false;
+	}
+
+	return true;
+}
+
+bool mergeProfiles(CMakeCommand &cmake, const std::string &rawDir, const std::string &profileDir)
+{
+	std::vector<std::string> files;
+	fs::listFiles(rawDir.data(), files);
+	if (files.empty() && Process::dryRun == false)
+	{
+		Helpers::error("The training command has not written any profile in: ", rawDir.data());
+		return false;
+	}
+
+	const std::string makeDirCommand = "make_directory \"" + profileDir + "\"";
+	if (cmake.toolsMode(makeDirCommand.data()) == false)
+		return false;
+
+	if (isClang())
+	{
+		std::string command = std::string(llvmProfdataExecutable()) + " merge -output=\"" + fs::joinPath(profileDir, clangProfile) + "\"";
+		for (const std::string &file : files)
+		{
+			if (fs::endsWith(file, ".profraw"))
+				command += " \"" + file + "\"";
+		}
+		return Process::executeCommand(command.data());
+	}
+	else
+	{
+		// GCC merges the counters of every run by itself, the profile only needs to be stored
+		const std::string copyCommand = "copy_directory \"" + rawDir + "\" \"" + profileDir + "\"";
+		return cmake.toolsMode(copyCommand.data());
+	}
+}
+
+}
+
+///////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////
+
+void PgoMode::perform(GitCommand &git, CMakeCommand &cmake, CacheCommand &cache, const Settings &settings)
+{
+	assert(settings.mode() == Settings::Mode::PGO);
+	assert(settings.target() != Settings::Target::LIBS);
+
+	if (checkCompiler() == false)
+		return;
+
+	std::string jobsReason;
+	cmake.setJobs(JobCount::compute(settings.jobs(), jobsReason));
+
+	// Profiles only describe optimized code
+	Settings releaseSettings(settings);
+	releaseSettings.setBuildType(Settings::BuildType::RELEASE);
+
+	std::string engineHead;
+	if (git.retrieveHead(Helpers::nCineSourceDir(), engineHead) == false)
+	{
+		Helpers::error("Cannot retrieve the commit of the engine repository: ", Helpers::nCineSourceDir());
+		return;
+	}
+
+	std::string profileName = Settings::targetToString(settings.target());
+	profileName += isClang() ? "-clang" : "-gcc";
+	const std::string latestFile = fs::joinPath(profilesDir, profileName + ".latest");
+	const std::string rawDir = fs::joinPath(fs::currentDir(), fs::joinPath(profilesDir, profileName + ".raw"));
+
+	profileName += "-" + engineHead;
+	if (settings.target() == Settings::Target::GAME)
+	{
+		std::string gameName;
+		config().gameName(gameName);
+		std::string gameHead;
+		if (git.retrieveHead(gameName.data(), gameHead) == false)
+		{
+			Helpers::error("Cannot retrieve the commit of the game repository: ", gameName.data());
+			return;
+		}
+		profileName += "-" + gameHead;
+	}
+	std::string profileDir = fs::joinPath(fs::currentDir(), fs::joinPath(profilesDir, profileName));
+
+	bool hasProfile = (settings.clean() == false && fs::exists(profileDir.data()));
+	if (hasProfile)
+		Helpers::info("Reuse the profile of the current commits: ", profileDir.data());
+	else if (settings.clean() == false && settings.recentProfile())
+	{
+		std::ifstream file(latestFile);
+		std::string latestName;
+		if (file.is_open() && std::getline(file, latestName) && latestName.empty() == false)
+		{
+			const std::string latestDir = fs::joinPath(fs::currentDir(), fs::joinPath(profilesDir, latestName));
+			if (fs::exists(latestDir.data()))
+			{
+				profileDir = latestDir;
+				hasProfile = true;
+				Helpers::info("Reuse the most recent profile: ", profileDir.data());
+			}
+		}
+	}
+
+	if (hasProfile == false)
+	{
+		if (settings.trainingCommand().empty())
+		{
+			Helpers::error("No profile for the current commits, specify a training command with the '-train' option");
+			return;
+		}
+
+		// Counters of a previous training would be merged with the new ones
+		if (fs::exists(rawDir.data()))
+		{
+			const std::string removeCommand = cmake.removeDir() + ("\"" + rawDir + "\"");
+			cmake.toolsMode(removeCommand.data());
+		}
+
+		Helpers::info("Stage 1 of 4: build with instrumentation");
+		if (configureAndBuild(cmake, cache, releaseSettings, Stage::GENERATE, rawDir, profileDir) == false)
+		{
+			Helpers::error("Cannot build with instrumentation");
+			return;
+		}
+
+		Helpers::info("Stage 2 of 4: run the training command: ", settings.trainingCommand().data());
+		if (Process::executeCommand(settings.trainingCommand().data()) == false)
+		{
+			Helpers::error("The training command has failed");
+			return;
+		}
+
+		Helpers::info("Stage 3 of 4: merge the profiles in: ", profileDir.data());
+		if (mergeProfiles(cmake, rawDir, profileDir) == false)
+		{
+			Helpers::error("Cannot merge the profiles");
+			return;
+		}
+
+		if (Process::dryRun == false)
+		{
+			std::ofstream file(latestFile);
+			file << profileName << "\n";
+		}
+	}
+
+	Helpers::info("Stage 4 of 4: build with the profile applied");
+	if (configureAndBuild(cmake, cache, releaseSettings, Stage::USE, rawDir, profileDir) == false)
+		Helpers::error("Cannot build with the profile applied");
+}
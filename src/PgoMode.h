@@ -0,0 +1,12 @@
+#pragma once
+
+class Settings;
+class GitCommand;
+class CMakeCommand;
+class CacheCommand;
+
+class PgoMode
+{
+  public:
+	static void perform(GitCommand &git, CMakeCommand &cmake, CacheCommand &cache, const Settings &settings);
+};
@@ -1,4 +1,5 @@
 #include <cassert>
+#include <cstdlib>
 #include <iostream>
 #include <string>
 #include "Process.h"
@@ -7,12 +8,16 @@
 #ifdef _WIN32
 	#define WIN32_LEAN_AND_MEAN
 	#include <Windows.h>
+#else
+	#include <fcntl.h>
+	#include <unistd.h>
+	#include <sys/wait.h>
 #endif
 
 namespace {
 
 const int MaxLength = 1024;
-char buffer[MaxLength];
+thread_local char buffer[MaxLength];
 
 FILE *popenWrapper(const char *command, const char *mode)
 {
@@ -91,34 +96,84 @@ void Process::detectPowerShell()
 
 bool Process::executeCommand(const char *command)
 {
-	return executeCommand(command, nullptr, Echo::ENABLED, OverrideDryRun::DISABLED);
+	return executeCommand(command, nullptr, Echo::ENABLED, OverrideDryRun::DISABLED, nullptr);
 }
 
 bool Process::executeCommand(const char *command, Echo echoMode)
 {
-	return executeCommand(command, nullptr, echoMode, OverrideDryRun::DISABLED);
+	return executeCommand(command, nullptr, echoMode, OverrideDryRun::DISABLED, nullptr);
 }
 
 bool Process::executeCommand(const char *command, std::string &output)
 {
-	return executeCommand(command, &output, Echo::ENABLED, OverrideDryRun::DISABLED);
+	return executeCommand(command, &output, Echo::ENABLED, OverrideDryRun::DISABLED, nullptr);
 }
 
 bool Process::executeCommand(const char *command, std::string &output, Echo echoMode)
 {
-	return executeCommand(command, &output, echoMode, OverrideDryRun::DISABLED);
+	return executeCommand(command, &output, echoMode, OverrideDryRun::DISABLED, nullptr);
 }
 
 bool Process::executeCommand(const char *command, std::string &output, Echo echoMode, OverrideDryRun overrideMode)
 {
-	return executeCommand(command, &output, echoMode, overrideMode);
+	return executeCommand(command, &output, echoMode, overrideMode, nullptr);
+}
+
+bool Process::executeCommand(const char *command, const std::function<void(const char *)> &lineFunction)
+{
+	return executeCommand(command, nullptr, Echo::COMMAND_ONLY, OverrideDryRun::DISABLED, &lineFunction);
+}
+
+bool Process::startDetached(const char *command)
+{
+	assert(command);
+
+#ifdef _WIN32
+	std::string commandLine = command;
+	STARTUPINFOA startupInfo = {};
+	startupInfo.cb = sizeof(startupInfo);
+	PROCESS_INFORMATION processInfo = {};
+	// No handle is inherited, so that the process does not keep a pipe of ncline open
+	if (CreateProcessA(nullptr, &commandLine[0], nullptr, nullptr, FALSE, DETACHED_PROCESS | CREATE_NEW_PROCESS_GROUP, nullptr, nullptr, &startupInfo, &processInfo) == FALSE)
+		return false;
+
+	CloseHandle(processInfo.hThread);
+	CloseHandle(processInfo.hProcess);
+	return true;
+#else
+	const pid_t pid = fork();
+	if (pid < 0)
+		return false;
+	else if (pid == 0)
+	{
+		// The grandchild is adopted by init, so it is not waited for and its resource usage is not added to the one of the children
+		const pid_t grandchildPid = fork();
+		if (grandchildPid == 0)
+		{
+			setsid();
+			const int nullFd = open("/dev/null", O_RDWR);
+			if (nullFd >= 0)
+			{
+				dup2(nullFd, STDIN_FILENO);
+				dup2(nullFd, STDOUT_FILENO);
+				dup2(nullFd, STDERR_FILENO);
+			}
+			execl("/bin/sh", "sh", "-c", command, static_cast<char *>(nullptr));
+			_exit(EXIT_FAILURE);
+		}
+		_exit(grandchildPid > 0 ? EXIT_SUCCESS : EXIT_FAILURE);
+	}
+
+	int status = 0;
+	return (waitpid(pid, &status, 0) == pid && WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS);
+#endif
 }
 
 ///////////////////////////////////////////////////////////
 // PRIVATE FUNCTIONS
 ///////////////////////////////////////////////////////////
 
-bool Process::executeCommand(const char *command, std::string *output, Echo echoMode, OverrideDryRun overrideMode)
+bool Process::executeCommand(const char *command, std::string *output, Echo echoMode, OverrideDryRun overrideMode, const std::function<void(const char *)> *lineFunction)
 {
 	assert(command);
 
@@ -139,14 +194,28 @@ bool Process::executeCommand(const char *command, std::string *output, Echo echo
 	if (output)
 		output->clear();
 
+	// Lines longer than the buffer are read in more than one chunk
+	std::string line;
 	while (fgets(buffer, MaxLength, fp))
 	{
 		if (output)
 			output->append(buffer);
-		if (echoMode == Echo::ENABLED)
-			std::cout << buffer << std::flush;
+		if (lineFunction)
+		{
+			line.append(buffer);
+			if (line.back() == '\n')
+			{
+				(*lineFunction)(line.data());
+				line.clear();
+			}
+		}
+		else if (echoMode == Echo::ENABLED)
+			Helpers::output() << buffer << std::flush;
 	}
 
+	if (lineFunction && line.empty() == false)
+		(*lineFunction)(line.data());
+
 	if (feof(fp))
 		return (pcloseWrapper(fp) == EXIT_SUCCESS);
 	else
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <functional>
 
 /// A class to execute a process and retrieve its output
 class Process
@@ -32,7 +33,11 @@ class Process
 	static bool executeCommand(const char *command, std::string &output);
 	static bool executeCommand(const char *command, std::string &output, Echo echoMode);
 	static bool executeCommand(const char *command, std::string &output, Echo echoMode, OverrideDryRun overrideMode);
+	/// Passes every line of the output to a function instead of echoing it
+	static bool executeCommand(const char *command, const std::function<void(const char *)> &lineFunction);
+	/// Starts a command without an output that is not waited for and keeps running after ncline exits
+	static bool startDetached(const char *command);
 
   private:
-	static bool executeCommand(const char *command, std::string *output, Echo echoMode, OverrideDryRun overrideMode);
+	static bool executeCommand(const char *command, std::string *output, Echo echoMode, OverrideDryRun overrideMode, const std::function<void(const char *)> *lineFunction);
 };
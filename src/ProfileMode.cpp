@@ -0,0 +1,143 @@
+#include <cassert>
+#include <cstdio>
+#include <string>
+#include "ProfileMode.h"
+#include "FlameGraph.h"
+#include "CMakeCommand.h"
+#include "FileSystem.h"
+#include "Settings.h"
+#include "Configuration.h"
+#include "Process.h"
+#include "Helpers.h"
+
+namespace {
+
+/// The directory that keeps the samples and the flame graphs of the last profile of every target and build type
+const char *profilesDir = "ncline-profile";
+/// The sampling frequency, not a multiple of common timer frequencies to avoid lockstep sampling
+const unsigned int SamplingFrequency = 999;
+
+/// Quotes an argument for the shell, unless it only has characters without a special meaning
+std::string shellQuote(const std::string &argument)
+{
+	if (argument.empty() == false && argument.find_first_not_of("abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789_-+=.,:/@%") == std::string::npos)
+		return argument;
+
+	std::string quoted = "'";
+	for (const char c : argument)
+	{
+		if (c == '\'')
+			quoted += "'\\''";
+		else
+			quoted += c;
+	}
+	quoted += "'";
+	return quoted;
+}
+
+}
+
+///////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////
+
+bool ProfileMode::perform(CMakeCommand &cmake, const Settings &settings)
+{
+	assert(settings.mode() == Settings::Mode::PROFILE);
+	assert(settings.target() != Settings::Target::LIBS);
+
+#ifndef __linux__
+	Helpers::error("The profiling mode needs perf, which is only available on Linux");
+	return false;
+#else
+	if (config().platform() != Configuration::Platform::DESKTOP)
+	{
+		Helpers::error("Only the desktop builds can be profiled on the host");
+		return false;
+	}
+	else if (settings.profileCommand().empty())
+	{
+		Helpers::error("Specify the command to profile after '--'");
+		return false;
+	}
+
+	const std::string buildDir = Helpers::targetBuildDir(settings);
+	if (fs::isDirectory(buildDir.data()) == false)
+	{
+		Helpers::error("Build the target before profiling it, cannot find the build directory: ", buildDir.data());
+		return false;
+	}
+
+	// The command runs in the build directory, the output paths need to be absolute
+	std::string profileName = Settings::targetToString(settings.target());
+	profileName += std::string("-") + Settings::buildTypeToString(settings.buildType());
+	const std::string basePath = fs::joinPath(fs::currentDir(), fs::joinPath(profilesDir, profileName));
+	const std::string dataFile = basePath + ".data";
+	const std::string scriptFile = basePath + ".perf.txt";
+	const std::string foldedFile = basePath + ".folded";
+	const std::string svgFile = basePath + ".svg";
+
+	std::string profiledCommand;
+	for (const std::string &argument : settings.profileCommand())
+		profiledCommand += (profiledCommand.empty() ? "" : " ") + shellQuote(argument);
+
+	const std::string makeDirCommand = std::string("make_directory ") + profilesDir;
+	if (cmake.toolsMode(makeDirCommand.data()) == false)
+	{
+		Helpers::error("Cannot create the profiles directory: ", profilesDir);
+		return false;
+	}
+	// A stale file would hide a failure to record
+	if (Process::dryRun == false)
+		std::remove(dataFile.data());
+
+	// DWARF call graphs do not need the frame pointers omitted by optimized builds
+	Helpers::info("Profile in ", buildDir.data());
+	const std::string recordCommand = "cd " + shellQuote(buildDir) + " && perf record -F " + std::to_string(SamplingFrequency) +
+	                                  " --call-graph dwarf -o " + shellQuote(dataFile) + " -- " + profiledCommand;
+	const bool recorded = Process::executeCommand(recordCommand.data());
+	if (Process::dryRun == false && fs::exists(dataFile.data()) == false)
+	{
+		Helpers::error("Cannot record the samples, check that perf is installed and that kernel.perf_event_paranoid is at most 2");
+		return false;
+	}
+	else if (recorded == false)
+		Helpers::error("The profiled command has failed, the recorded samples are shown anyway");
+
+	const std::string scriptCommand = "perf script -i " + shellQuote(dataFile) + " > " + shellQuote(scriptFile);
+	if (Process::executeCommand(scriptCommand.data()) == false)
+	{
+		Helpers::error("Cannot extract the call stacks from: ", dataFile.data());
+		return false;
+	}
+
+	if (Process::dryRun)
+		return true;
+
+	FlameGraph flameGraph;
+	if (flameGraph.addPerfScript(scriptFile.data()) == false || flameGraph.numSamples() == 0)
+	{
+		Helpers::error("No samples found in: ", scriptFile.data());
+		return false;
+	}
+	// The script output is many times larger than the folded stacks
+	std::remove(scriptFile.data());
+
+	const std::string title = Settings::targetToString(settings.target()) + std::string(": ") + profiledCommand;
+	if (flameGraph.writeFolded(foldedFile.data()) == false || flameGraph.writeSvg(svgFile.data(), title.data()) == false)
+	{
+		Helpers::error("Cannot write the flame graph: ", svgFile.data());
+		return false;
+	}
+
+	const int MaxLength = 64;
+	char buffer[MaxLength];
+	snprintf(buffer, MaxLength, "%lu", flameGraph.numSamples());
+	Helpers::info("Samples recorded: ", buffer);
+	flameGraph.printHottest(settings.reportEntries());
+	Helpers::info("Folded stacks written to: ", foldedFile.data());
+	Helpers::info("Flame graph written to: ", svgFile.data());
+
+	return recorded;
+#endif
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+class Settings;
+class CMakeCommand;
+
+class ProfileMode
+{
+  public:
+	/// Returns false if the command could not be profiled
+	static bool perform(CMakeCommand &cmake, const Settings &settings);
+};
@@ -0,0 +1,162 @@
+#include <cassert>
+#include <cstdio>
+#include <algorithm>
+#include <iostream>
+#include "ReportMode.h"
+#include "CMakeCommand.h"
+#include "NinjaLog.h"
+#include "NinjaGraph.h"
+#include "NinjaDeps.h"
+#include "Settings.h"
+#include "Configuration.h"
+#include "Helpers.h"
+
+namespace {
+
+void reportBuild(const Settings &settings)
+{
+	const std::string buildDir = Helpers::targetBuildDir(settings);
+	Helpers::info("Report the last build of: ", buildDir.data());
+
+	const std::string filename = NinjaLog::logFile(buildDir);
+	NinjaLog ninjaLog;
+	if (ninjaLog.load(filename.data()))
+		ninjaLog.printReport(settings.reportEntries());
+	else
+		Helpers::error("Cannot read the Ninja build log: ", filename.data());
+}
+
+void reportCriticalPath(const Settings &settings)
+{
+	const std::string buildDir = Helpers::targetBuildDir(settings);
+	Helpers::info("Report the critical path of: ", buildDir.data());
+
+	const std::string logFilename = NinjaLog::logFile(buildDir);
+	NinjaLog ninjaLog;
+	if (ninjaLog.load(logFilename.data()) == false)
+	{
+		Helpers::error("Cannot read the Ninja build log: ", logFilename.data());
+		return;
+	}
+
+	NinjaGraph graph;
+	if (graph.load(buildDir) == false)
+	{
+		Helpers::error("Cannot read the Ninja build file: ", NinjaGraph::buildFile(buildDir).data());
+		return;
+	}
+	// Edges that were not rebuilt by the last run keep the duration of the run that built them
+	graph.setDurations(ninjaLog.durations());
+
+	std::vector<unsigned int> path;
+	const unsigned int length = graph.criticalPath(path);
+	if (length == 0)
+	{
+		Helpers::info("No timed steps in the Ninja build log");
+		return;
+	}
+
+	const int MaxLength = 512;
+	char buffer[MaxLength];
+	snprintf(buffer, MaxLength, "%zu steps, %.2f s (last build wall time %.2f s)", path.size(), length / 1000.0f, ninjaLog.wallTime() / 1000.0f);
+	Helpers::info("Critical path: ", buffer);
+	for (unsigned int edge : path)
+	{
+		if (graph.edgeDuration(edge) == 0)
+			continue;
+		snprintf(buffer, MaxLength, "%10.2f s  %s", graph.edgeDuration(edge) / 1000.0f, graph.edgeOutput(edge).data());
+		std::cout << buffer << "\n";
+	}
+
+	// Halving an edge may move the critical path onto a different chain, the whole graph is evaluated again
+	std::vector<unsigned int> slowestEdges(path);
+	std::sort(slowestEdges.begin(), slowestEdges.end(), [&graph](unsigned int a, unsigned int b) { return graph.edgeDuration(a) > graph.edgeDuration(b); });
+	Helpers::info("Theoretical speedup when halving a step of the critical path:");
+	for (unsigned int i = 0; i < slowestEdges.size() && i < settings.reportEntries(); i++)
+	{
+		const unsigned int edge = slowestEdges[i];
+		if (graph.edgeDuration(edge) == 0)
+			break;
+
+		const unsigned int newLength = graph.criticalPathLength(edge, graph.edgeDuration(edge) / 2);
+		snprintf(buffer, MaxLength, "%10.2f s  %5.2fx  %s", newLength / 1000.0f, length / static_cast<float>(newLength), graph.edgeOutput(edge).data());
+		std::cout << buffer << "\n";
+	}
+	std::cout << std::flush;
+}
+
+void reportIncludes(const CMakeCommand &cmake, const Settings &settings)
+{
+	const std::string buildDir = Helpers::targetBuildDir(settings);
+	Helpers::info("Report the header dependencies of: ", buildDir.data());
+
+	NinjaDeps ninjaDeps;
+	if (ninjaDeps.load(cmake.ninjaExecutable(), buildDir) == false || ninjaDeps.numTargets() == 0)
+	{
+		Helpers::error("Cannot read the Ninja dependency database of: ", buildDir.data());
+		return;
+	}
+
+	// Without a log the headers are still ranked by the number of dependent translation units
+	const std::string logFilename = NinjaLog::logFile(buildDir);
+	NinjaLog ninjaLog;
+	if (ninjaLog.load(logFilename.data()) == false)
+		Helpers::error("Cannot read the Ninja build log: ", logFilename.data());
+
+	std::string sourceDir;
+	switch (settings.target())
+	{
+		case Settings::Target::LIBS:
+			if (config().platform() == Configuration::Platform::ANDROID)
+				sourceDir = Helpers::nCineAndroidLibrariesSourceDir();
+			else
+				sourceDir = Helpers::nCineLibrariesSourceDir();
+			break;
+		case Settings::Target::ENGINE:
+			sourceDir = Helpers::nCineSourceDir();
+			break;
+		case Settings::Target::GAME:
+			config().gameName(sourceDir);
+			break;
+	}
+
+	// Generated headers live in the build directory
+	const std::vector<std::string> projectDirs = { sourceDir, buildDir };
+	ninjaDeps.printHeaderCosts(ninjaLog.durations(), projectDirs, settings.reportEntries());
+}
+
+}
+
+///////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////
+
+void ReportMode::perform(CMakeCommand &cmake, const Settings &settings)
+{
+	assert(settings.mode() == Settings::Mode::REPORT);
+
+	// Only the Ninja generators leave a log of the build steps
+	if (config().withNinja() == false || cmake.ninjaFound() == false || CMakeCommand::generatorIsVisualStudio())
+	{
+		Helpers::error("Build reports need the Ninja generator");
+		return;
+	}
+
+	Settings buildTypeSettings(settings);
+	for (Settings::BuildType buildType : settings.buildTypes())
+	{
+		buildTypeSettings.setBuildType(buildType);
+		switch (settings.report())
+		{
+			case Settings::Report::BUILD:
+				reportBuild(buildTypeSettings);
+				break;
+			case Settings::Report::CRITICAL_PATH:
+				reportCriticalPath(buildTypeSettings);
+				break;
+			case Settings::Report::INCLUDES:
+				reportIncludes(cmake, buildTypeSettings);
+				break;
+		}
+	}
+}
@@ -0,0 +1,10 @@
+#pragma once
+
+class Settings;
+class CMakeCommand;
+
+class ReportMode
+{
+  public:
+	static void perform(CMakeCommand &cmake, const Settings &settings);
+};
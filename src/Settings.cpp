@@ -1,4 +1,6 @@
 #include <iostream>
+#include <cstdlib>
+#include <cstdio>
 #include <clipp.h>
 #include "Settings.h"
 #include "Configuration.h"
@@ -16,6 +18,44 @@ const char *programName = "ncline";
 // PUBLIC FUNCTIONS
 ///////////////////////////////////////////////////////////
 
+const char *Settings::targetToString(Target target)
+{
+	switch (target)
+	{
+		case Target::LIBS: return "libs";
+		case Target::ENGINE: return "engine";
+		case Target::GAME: return "game";
+	}
+	return nullptr;
+}
+
+const char *Settings::buildTypeToString(BuildType buildType)
+{
+	switch (buildType)
+	{
+		case BuildType::DEBUG: return "debug";
+		case BuildType::RELEASE: return "release";
+		case BuildType::RELWITHDEBINFO: return "relwithdebinfo";
+		case BuildType::MINSIZEREL: return "minsizerel";
+		case BuildType::PROFILE: return "profile";
+	}
+	return nullptr;
+}
+
+const char *Settings::buildTypeToConfigString(BuildType buildType)
+{
+	switch (buildType)
+	{
+		case BuildType::DEBUG: return "Debug";
+		case BuildType::RELEASE: return "Release";
+		case BuildType::RELWITHDEBINFO: return "RelWithDebInfo";
+		case BuildType::MINSIZEREL: return "MinSizeRel";
+		// Optimized code with debug information, frame pointers are added at configuration time
+		case BuildType::PROFILE: return "RelWithDebInfo";
+	}
+	return nullptr;
+}
+
 bool Settings::parseArguments(int argc, char **argv)
 {
 	// clang-format off
@@ -29,6 +69,10 @@ bool Settings::parseArguments(int argc, char **argv)
 	                    option("-ninja").call([] { config().setWithNinja(true); }) |
 	                    option("-no-ninja").call([] { config().setWithNinja(false); })
 	                ).doc("(do not) prefer Ninja as a CMake generator"),
+	                (
+	                    option("-ninja-multi-config").call([] { config().setWithNinjaMultiConfig(true); }) |
+	                    option("-no-ninja-multi-config").call([] { config().setWithNinjaMultiConfig(false); })
+	                ).doc("(do not) use the multi-configuration variant of the Ninja generator"),
 #ifdef _WIN32
 	                ((
 	                    option("-mingw").call([] { config().setWithMinGW(true); }) |
@@ -50,6 +94,21 @@ bool Settings::parseArguments(int argc, char **argv)
 	                    option("-gcc").call([] { config().setCompiler(Configuration::Compiler::GCC); }) |
 	                    option("-clang").call([] { config().setCompiler(Configuration::Compiler::CLANG); })
 	                ).doc("prefer GCC or Clang to compile on Linux and MinGW/MSYS"),
+	                (
+	                    option("-default-linker").call([] { config().setLinker(Configuration::Linker::DEFAULT); }) |
+	                    option("-lld").call([] { config().setLinker(Configuration::Linker::LLD); }) |
+	                    option("-mold").call([] { config().setLinker(Configuration::Linker::MOLD); })
+	                ).doc("link with the default linker of the compiler, with LLD or with mold"),
+#ifndef _WIN32
+	                (
+	                    option("-split-dwarf").call([] { config().setWithSplitDwarf(true); }) |
+	                    option("-no-split-dwarf").call([] { config().setWithSplitDwarf(false); })
+	                ).doc("(do not) keep the debug information out of the linked files, in separate `.dwo` files"),
+	                (
+	                    option("-compressed-debug").call([] { config().setWithCompressedDebug(true); }) |
+	                    option("-no-compressed-debug").call([] { config().setWithCompressedDebug(false); })
+	                ).doc("(do not) compress the debug sections of object and linked files"),
+#endif
 #endif
 	                ((
 	                    option("-armeabi-v7a").call([] { config().setAndroidArch(Configuration::AndroidArch::ARMEABI_V7A); }) |
@@ -68,6 +127,41 @@ bool Settings::parseArguments(int argc, char **argv)
 	                (option("-ninja-exe") & value("executable").call([&](const std::string &ninjaExe) { config().setNinjaExecutable(ninjaExe); })).doc("set the Ninja command executable"),
 	                (option("-emcmake-exe") & value("executable").call([&](const std::string &emcmakeExe) { config().setEmcmakeExecutable(emcmakeExe); })).doc("set the Emscripten emcmake command executable"),
 	                (option("-doxygen-exe") & value("executable").call([&](const std::string &doxygenExe) { config().setDoxygenExecutable(doxygenExe); })).doc("set the Doxygen command executable"),
+	                ((
+	                    option("-ccache").call([] { config().setCompilerCache(Configuration::CompilerCache::CCACHE); }) |
+	                    option("-sccache").call([] { config().setCompilerCache(Configuration::CompilerCache::SCCACHE); }) |
+	                    option("-no-cache").call([] { config().setCompilerCache(Configuration::CompilerCache::NONE); })
+	                ).doc("(do not) use ccache or sccache as a compiler launcher"),
+	                (option("-cache-dir") & value("path").call([&](const std::string &directory) { config().setCompilerCacheDir(directory); })).doc("set the shared compiler cache directory"),
+	                (option("-cache-size") & value("size").call([&](const std::string &size) { config().setCompilerCacheSize(size); })).doc("set the maximum size of the compiler cache"),
+	                (option("-binary-cache-dir") & value("path").call([&](const std::string &directory) { config().setBinaryCacheDir(directory); })).doc("set the shared directory of cached engine builds, an empty path disables it"),
+	                (option("-thinlto-cache-dir") & value("path").call([&](const std::string &directory) { config().setThinLtoCacheDir(directory); })).doc("set the directory of the incremental ThinLTO cache")).doc("Compiler cache settings"),
+#ifndef _WIN32
+	                (
+	                    option("-jobserver").call([] { config().setWithJobServer(true); }) |
+	                    option("-no-jobserver").call([] { config().setWithJobServer(false); })
+	                ).doc("(do not) share a single jobserver among all the nested builds"),
+#endif
+	                (
+	                    option("-compact-progress").call([] { config().setWithCompactProgress(true); }) |
+	                    option("-no-compact-progress").call([] { config().setWithCompactProgress(false); })
+	                ).doc("(do not) replace the progress lines of a build with a single status line"),
+	                (option("-regression-threshold") & integer("percent").call([&](const std::string &percent) { config().setRegressionThreshold(strtoul(percent.data(), nullptr, 10)); })).doc("set how much slower than the median a build should be to be flagged by the history"),
+	                (option("-job-memory") & integer("megabytes").call([&](const std::string &megabytes) { config().setJobMemory(strtoul(megabytes.data(), nullptr, 10)); })).doc("set the memory budget of a build job, used to compute the number of parallel jobs"),
+	                (
+	                    option("-no-lto").call([] { config().setLto(Configuration::Lto::OFF); }) |
+	                    option("-lto").call([] { config().setLto(Configuration::Lto::FULL); }) |
+	                    option("-thin-lto").call([] { config().setLto(Configuration::Lto::THIN); })
+	                ).doc("(do not) use full or thin link-time optimization for release and distribution builds"),
+	                (
+	                    option("-unity").call([] { config().setWithUnityBuild(true); }) |
+	                    option("-no-unity").call([] { config().setWithUnityBuild(false); })
+	                ).doc("(do not) compile the engine and the game as unity builds, merging their sources in batches"),
+	                (option("-unity-batch-size") & integer("size").call([&](const std::string &size) { config().setUnityBatchSize(strtoul(size.data(), nullptr, 10)); })).doc("set the number of sources merged in a unity source"),
+	                (
+	                    option("-pch").call([] { config().setWithPrecompiledHeaders(true); }) |
+	                    option("-no-pch").call([] { config().setWithPrecompiledHeaders(false); })
+	                ).doc("(do not) use the precompiled headers declared by the engine and the game"),
 	                (option("-prefix-path") & value("path").call([&](const std::string &directory) { config().setCMakePrefixPath(directory); })).doc("set the CMAKE_PREFIX_PATH variable for the engine"),
 	                (option("-cmake-args") & value("args").call([&](const std::string &cmakeArgs) { config().setEngineCMakeArguments(cmakeArgs); })).doc("additional CMake arguments to configure the engine"),
 	                (option("-branch") & value("name").call([&](const std::string &branchName) { config().setBranchName(branchName); })).doc("branch name for engine and projects"),
@@ -96,27 +190,133 @@ bool Settings::parseArguments(int argc, char **argv)
 	                 (command("engine").set(target_, Target::ENGINE) |
 	                 command("game").set(target_, Target::GAME)).doc("choose what to distribute"));
 
+	auto reportMode = (command("report").set(mode_, Mode::REPORT).doc("report mode"),
+	                   (command("build").set(report_, Report::BUILD).doc("analyze the last Ninja build and list its slowest steps") |
+	                   command("critical-path").set(report_, Report::CRITICAL_PATH).doc("find the chain of dependent steps that bounds the build time") |
+	                   command("includes").set(report_, Report::INCLUDES).doc("rank the headers by the compile time of the translation units that include them")),
+	                   (command("libs").set(target_, Target::LIBS) |
+	                   command("engine").set(target_, Target::ENGINE) |
+	                   command("game").set(target_, Target::GAME)).doc("choose what to report about"));
+
+	auto historyMode = (command("history").set(mode_, Mode::HISTORY).doc("history mode"),
+	                    (command("libs").set(target_, Target::LIBS) |
+	                    command("engine").set(target_, Target::ENGINE) |
+	                    command("game").set(target_, Target::GAME)).doc("choose the target of the recorded runs to show"));
+
+	auto analyzeMode = (command("analyze").set(mode_, Mode::ANALYZE).doc("compilation analysis mode, with Clang"),
+	                    (command("engine").set(target_, Target::ENGINE) |
+	                    command("game").set(target_, Target::GAME)).doc("choose what to analyze"));
+
+	auto watchMode = (command("watch").set(mode_, Mode::WATCH).doc("watch mode, rebuild when the sources change"),
+	                  (command("engine").set(target_, Target::ENGINE) |
+	                  command("game").set(target_, Target::GAME)).doc("choose what to watch and rebuild"));
+
+	auto pgoMode = (command("pgo").set(mode_, Mode::PGO).doc("profile-guided optimization mode"),
+	                (command("engine").set(target_, Target::ENGINE) |
+	                command("game").set(target_, Target::GAME)).doc("choose what to optimize"),
+	                (option("-train") & value("command", trainingCommand_)).doc("set the command that runs the instrumented build to write a profile"),
+	                option("-recent").set(recentProfile_, true).doc("use the most recent profile if there is none for the current commits"),
+	                option("-clean").set(clean_, true).doc("train again even if there is a profile for the current commits"));
+
+	auto testMode = (command("test").set(mode_, Mode::TEST).doc("test mode, run the tests with CTest"),
+	                 (command("engine").set(target_, Target::ENGINE) |
+	                 command("game").set(target_, Target::GAME)).doc("choose what to test"),
+	                 option("-all").set(allTests_, true).doc("run all the tests, not only the ones affected by the changes since the last successful run"),
+	                 (option("-shard") & value("index/count").call([this](const std::string &shard) { parseShard(shard); })).doc("run only one of the shards the tests are split into, by their recorded durations"),
+	                 (option("-junit") & value("file", junitFile_)).doc("write a JUnit XML summary of the tests"),
+	                 (option("-json") & value("file", jsonFile_)).doc("write a JSON summary of the tests"));
+
+	auto benchMode = (command("bench").set(mode_, Mode::BENCH).doc("benchmark mode, run the engine benchmarks and compare the stored results"),
+	                  (command("engine").set(target_, Target::ENGINE).doc("build and run the engine benchmarks, then store their results") |
+	                  (command("compare").set(benchCompare_, true) & value("baseline", benchBaseline_) & value("current", benchCurrent_)).doc("report the significant differences between two stored runs")),
+	                  (option("-repetitions") & integer("count", repetitions_)).doc("set the number of times every benchmark is repeated"),
+	                  (option("-cpu") & integer("index", benchCpu_)).doc("pin the benchmarks to a CPU, the last one if unspecified (Linux only)"),
+	                  (option("-filter") & value("regex", benchFilter_)).doc("run only the benchmarks that match a regular expression"),
+	                  (option("release").call([this] { addBuildType(BuildType::RELEASE); }) |
+	                  option("profile").call([this] { addBuildType(BuildType::PROFILE); })).doc("choose the build type of the benchmarks, release if unspecified"));
+
+	auto profileMode = (command("profile").set(mode_, Mode::PROFILE).doc("profiling mode, run a command under perf and draw a flame graph (Linux only)"),
+	                    (command("engine").set(target_, Target::ENGINE) |
+	                    command("game").set(target_, Target::GAME)).doc("choose the build directory to run the command in"),
+	                    (option("-entries") & integer("entries", reportEntries_)).doc("set the number of hottest functions to show"),
+	                    (command("--") & greedy(values("command", profileCommand_))).doc("the command to profile and its arguments"));
+
+	auto sizeMode = (command("size").set(mode_, Mode::SIZE).doc("size mode, break down the size of the binaries and compare it with the last analysis or distribution"),
+	                 (command("engine").set(target_, Target::ENGINE) |
+	                 command("game").set(target_, Target::GAME)).doc("choose the binaries to analyze"),
+	                 option("-dist").set(sizeOfDist_, true).doc("analyze the binaries of the distribution directory instead of the build directory"),
+	                 (option("-entries") & integer("entries", reportEntries_)).doc("set the number of entries in every list of the analysis"));
+
+	auto buildTypeCommands = (command("debug").call([this] { addBuildType(BuildType::DEBUG); }) |
+	                          command("release").call([this] { addBuildType(BuildType::RELEASE); }) |
+	                          command("relwithdebinfo").call([this] { addBuildType(BuildType::RELWITHDEBINFO); }) |
+	                          command("minsizerel").call([this] { addBuildType(BuildType::MINSIZEREL); }) |
+	                          command("profile").call([this] { addBuildType(BuildType::PROFILE); }));
+	auto buildTypeOptions = (option("debug").call([this] { addBuildType(BuildType::DEBUG); }) |
+	                         option("release").call([this] { addBuildType(BuildType::RELEASE); }) |
+	                         option("relwithdebinfo").call([this] { addBuildType(BuildType::RELWITHDEBINFO); }) |
+	                         option("minsizerel").call([this] { addBuildType(BuildType::MINSIZEREL); }) |
+	                         option("profile").call([this] { addBuildType(BuildType::PROFILE); }));
+
 	if (CMakeCommand::generatorIsMultiConfig() == false)
-		confMode.push_back((command("debug").set(buildType_, BuildType::DEBUG) | command("release").set(buildType_, BuildType::RELEASE)).doc("choose debug or release build type"));
+	{
+		// Multiple build types are configured concurrently
+		confMode.push_back(repeatable(buildTypeCommands).doc("choose one or more build types"));
+		// Every build type has its own build directory
+		buildMode.push_back(repeatable(buildTypeOptions).doc("choose the build types of the directories to build, release if unspecified"));
+		reportMode.push_back(repeatable(buildTypeOptions).doc("choose the build types of the directories to report about, release if unspecified"));
+	}
 	else
 	{
 		// When compiling Android with the Visual Studio generator the CMAKE_BUILD_TYPE variable needs to be set
 		if (config().platform() == Configuration::Platform::ANDROID)
-			confMode.push_back((command("debug").set(buildType_, BuildType::DEBUG) | command("release").set(buildType_, BuildType::RELEASE)).doc("choose debug or release build type for Android"));
-		buildMode.push_back((command("debug").set(buildType_, BuildType::DEBUG) | command("release").set(buildType_, BuildType::RELEASE)).doc("choose debug or release build configuration"));
+			confMode.push_back(repeatable(buildTypeCommands).doc("choose one or more build types for Android"));
+		else
+			confMode.push_back(option("profile").call([this] { addBuildType(BuildType::PROFILE); }).doc("configure the separate profiling build directory"));
+		buildMode.push_back(repeatable(buildTypeCommands).doc("choose one or more build configurations"));
+		reportMode.push_back(repeatable(buildTypeOptions).doc("choose the build types of the directories to report about, release if unspecified"));
 	}
 
+	analyzeMode.push_back(buildTypeOptions.doc("choose the build type to analyze, release if unspecified"));
+	watchMode.push_back(buildTypeOptions.doc("choose the build type to rebuild, release if unspecified"));
+	testMode.push_back(buildTypeOptions.doc("choose the build type to test, release if unspecified"));
+	profileMode.push_back(buildTypeOptions.doc("choose the build type to profile, relwithdebinfo if unspecified"));
+	sizeMode.push_back(buildTypeOptions.doc("choose the build type of the directory to analyze, release if unspecified"));
+
 	auto cleanOption = option("-clean").set(clean_, true).doc("remove an existing build directory before recreating it");
 	confMode.push_back(cleanOption);
 	distMode.push_back(cleanOption);
 
+	confMode.push_back((option("-profile").set(profileConfiguration_, true) & opt_integer("entries", profileEntries_)).doc("profile the CMake configuration and report the slowest commands and files"));
+
+	buildMode.push_back(option("-stats").set(stats_, true).doc("compare the build time with the last one with different unity and precompiled header settings"));
+
+	auto jobsOption = (option("-j") & integer("jobs", jobs_)).doc("override the number of parallel build jobs");
+	buildMode.push_back(jobsOption);
+	distMode.push_back(jobsOption);
+	watchMode.push_back(jobsOption);
+	pgoMode.push_back(jobsOption);
+	testMode.push_back(jobsOption);
+	benchMode.push_back(jobsOption);
+	watchMode.push_back(option("-with-engine").set(watchEngine_, true).doc("also watch the engine sources and rebuild the engine before the game"));
+	watchMode.push_back((option("-debounce") & integer("milliseconds", debounceTime_)).doc("set the time without changes that starts a build"));
+
+	reportMode.push_back((option("-entries") & integer("entries", reportEntries_)).doc("set the number of entries in every list of the report"));
+	historyMode.push_back((option("-entries") & integer("entries", reportEntries_)).doc("set the number of recorded runs to show"));
+	analyzeMode.push_back((option("-entries") & integer("entries", reportEntries_)).doc("set the number of entries in every list of the analysis"));
+
 	auto dryRunOption = option("-dry-run").set(Process::dryRun, true).doc("show which commands to execute without executing them");
 	downloadMode.push_back(dryRunOption);
 	confMode.push_back(dryRunOption);
 	buildMode.push_back(dryRunOption);
 	distMode.push_back(dryRunOption);
+	analyzeMode.push_back(dryRunOption);
+	pgoMode.push_back(dryRunOption);
+	testMode.push_back(dryRunOption);
+	benchMode.push_back(dryRunOption);
+	profileMode.push_back(dryRunOption);
 
-	auto cli = ((setMode | downloadMode | confMode | buildMode | distMode |
+	auto cli = ((setMode | downloadMode | confMode | buildMode | distMode | reportMode | historyMode | analyzeMode | watchMode | pgoMode | testMode | benchMode | profileMode | sizeMode |
 	             command("--help").set(mode_, Mode::HELP).doc("show help") |
 	             command("--version").set(mode_, Mode::VERSION).doc("show version")));
 	// clang-format on
@@ -125,6 +325,12 @@ bool Settings::parseArguments(int argc, char **argv)
 	if (parse(argc, argv, cli))
 	{
 		parsed = true;
+		// Symbols and source lines are needed to make sense of the samples
+		if (mode_ == Mode::PROFILE && buildTypes_.empty())
+			buildType_ = BuildType::RELWITHDEBINFO;
+		if (buildTypes_.empty())
+			buildTypes_.push_back(buildType_);
+
 		if (mode_ == Mode::HELP)
 		{
 			auto fmt = doc_formatting{}.first_column(7).doc_column(15).last_column(99);
@@ -139,3 +345,34 @@ bool Settings::parseArguments(int argc, char **argv)
 
 	return parsed;
 }
+
+///////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+///////////////////////////////////////////////////////////
+
+void Settings::addBuildType(BuildType buildType)
+{
+	for (BuildType type : buildTypes_)
+	{
+		if (type == buildType)
+			return;
+	}
+
+	if (buildTypes_.empty())
+		buildType_ = buildType;
+	buildTypes_.push_back(buildType);
+}
+
+void Settings::parseShard(const std::string &shard)
+{
+	unsigned int index = 0;
+	unsigned int count = 0;
+	char trailing = '\0';
+	if (sscanf(shard.data(), "%u/%u%c", &index, &count, &trailing) == 2 && index >= 1 && index <= count)
+	{
+		shardIndex_ = index;
+		numShards_ = count;
+	}
+	else
+		numShards_ = 0;
+}
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <string>
+#include <vector>
+
 /// The settings parsed from the command line arguments
 class Settings
 {
@@ -11,6 +14,15 @@ class Settings
 		CONF,
 		BUILD,
 		DIST,
+		REPORT,
+		HISTORY,
+		ANALYZE,
+		WATCH,
+		PGO,
+		TEST,
+		BENCH,
+		PROFILE,
+		SIZE,
 
 		HELP,
 		VERSION
@@ -23,24 +35,110 @@ class Settings
 		GAME
 	};
 
+	enum class Report
+	{
+		BUILD,
+		CRITICAL_PATH,
+		INCLUDES
+	};
+
 	enum class BuildType
 	{
 		DEBUG,
-		RELEASE
+		RELEASE,
+		RELWITHDEBINFO,
+		MINSIZEREL,
+		PROFILE
 	};
 
+	static const char *targetToString(Target target);
+	static const char *buildTypeToString(BuildType buildType);
+	/// Returns the CMake configuration name of a build type, which is case sensitive for the Ninja Multi-Config generator
+	static const char *buildTypeToConfigString(BuildType buildType);
+
 	bool parseArguments(int argc, char **argv);
 
 	inline Mode mode() const { return mode_; }
 	inline Target target() const { return target_; }
 	inline BuildType buildType() const { return buildType_; }
+	/// All the build types specified on the command line, in order
+	inline const std::vector<BuildType> &buildTypes() const { return buildTypes_; }
+	inline void setBuildType(BuildType buildType) { buildType_ = buildType; }
 	inline bool downloadArtifact() const { return downloadArtifact_; }
 	inline bool clean() const { return clean_; }
+	inline bool profileConfiguration() const { return profileConfiguration_; }
+	inline unsigned int profileEntries() const { return profileEntries_; }
+	/// The number of parallel build jobs, zero if it should be computed automatically
+	inline unsigned int jobs() const { return jobs_; }
+	inline bool withStats() const { return stats_; }
+	inline Report report() const { return report_; }
+	inline unsigned int reportEntries() const { return reportEntries_; }
+	/// Returns true if the engine should be rebuilt before the game when its sources change
+	inline bool watchEngine() const { return watchEngine_; }
+	/// The time without changes that closes a batch of changed files, in milliseconds
+	inline unsigned int debounceTime() const { return debounceTime_; }
+	/// The command that exercises an instrumented build to write its profile
+	inline const std::string &trainingCommand() const { return trainingCommand_; }
+	/// Returns true if the most recent profile can be used when there is none for the current commits
+	inline bool recentProfile() const { return recentProfile_; }
+	/// The one-based index of the shard of tests to run, out of the number of shards
+	inline unsigned int shardIndex() const { return shardIndex_; }
+	/// The number of shards the tests are split into, zero if the shard is not valid
+	inline unsigned int numShards() const { return numShards_; }
+	/// Returns true if all the tests should run, not only the ones affected by the changes since the last successful run
+	inline bool allTests() const { return allTests_; }
+	/// The file of the JUnit XML summary of the tests, empty if it should not be written
+	inline const std::string &junitFile() const { return junitFile_; }
+	/// The file of the JSON summary of the tests, empty if it should not be written
+	inline const std::string &jsonFile() const { return jsonFile_; }
+	/// Returns true if two stored benchmark runs should be compared instead of running the benchmarks
+	inline bool benchCompare() const { return benchCompare_; }
+	/// The key, or its beginning, of the stored benchmark run to compare against
+	inline const std::string &benchBaseline() const { return benchBaseline_; }
+	/// The key, or its beginning, of the stored benchmark run to compare
+	inline const std::string &benchCurrent() const { return benchCurrent_; }
+	/// The number of times every benchmark is repeated
+	inline unsigned int repetitions() const { return repetitions_; }
+	/// The index of the CPU the benchmarks are pinned to, negative if it should be chosen automatically
+	inline int benchCpu() const { return benchCpu_; }
+	/// The regular expression that selects the benchmarks to run, empty if all of them should run
+	inline const std::string &benchFilter() const { return benchFilter_; }
+	/// The command to run under the profiler and its arguments
+	inline const std::vector<std::string> &profileCommand() const { return profileCommand_; }
+	/// Returns true if the size of the binaries of the distribution directory should be analyzed, instead of the build directory ones
+	inline bool sizeOfDist() const { return sizeOfDist_; }
 
   private:
 	Mode mode_ = Mode::HELP;
 	Target target_ = Target::LIBS;
 	BuildType buildType_ = BuildType::RELEASE;
+	std::vector<BuildType> buildTypes_;
 	bool downloadArtifact_ = false;
 	bool clean_ = false;
+	bool profileConfiguration_ = false;
+	unsigned int profileEntries_ = 10;
+	unsigned int jobs_ = 0;
+	bool stats_ = false;
+	Report report_ = Report::BUILD;
+	unsigned int reportEntries_ = 10;
+	bool watchEngine_ = false;
+	unsigned int debounceTime_ = 300;
+	std::string trainingCommand_;
+	bool recentProfile_ = false;
+	unsigned int shardIndex_ = 1;
+	unsigned int numShards_ = 1;
+	bool allTests_ = false;
+	std::string junitFile_;
+	std::string jsonFile_;
+	bool benchCompare_ = false;
+	std::string benchBaseline_;
+	std::string benchCurrent_;
+	unsigned int repetitions_ = 10;
+	int benchCpu_ = -1;
+	std::string benchFilter_;
+	std::vector<std::string> profileCommand_;
+	bool sizeOfDist_ = false;
+
+	void addBuildType(BuildType buildType);
+	void parseShard(const std::string &shard);
 };
@@ -0,0 +1,64 @@
+#include <cassert>
+#include <string>
+#include "SizeMode.h"
+#include "BinarySize.h"
+#include "CMakeCommand.h"
+#include "FileSystem.h"
+#include "Settings.h"
+#include "Configuration.h"
+#include "Helpers.h"
+
+///////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////
+
+void SizeMode::perform(CMakeCommand &cmake, const Settings &settings)
+{
+	assert(settings.mode() == Settings::Mode::SIZE);
+	assert(settings.target() != Settings::Target::LIBS);
+
+	std::string distDir = (settings.target() == Settings::Target::ENGINE) ? Helpers::nCineSourceDir() : std::string();
+	if (settings.target() == Settings::Target::GAME)
+		config().gameName(distDir);
+	Helpers::distDir(distDir, settings);
+
+	const std::string binaryDir = settings.sizeOfDist() ? distDir : Helpers::targetBuildDir(settings);
+	if (fs::isDirectory(binaryDir.data()) == false)
+	{
+		Helpers::error("Cannot find the directory of the binaries: ", binaryDir.data());
+		return;
+	}
+
+	Helpers::info("Analyze the binaries in: ", binaryDir.data());
+	BinarySize current;
+	if (current.addDirectory(binaryDir) == 0)
+	{
+		Helpers::error("No ELF executables or shared libraries found in: ", binaryDir.data());
+		return;
+	}
+	current.printBreakdown(settings.reportEntries());
+
+	// The build and distribution directories have different settings, each one is compared with its own baseline
+	const std::string snapshotFile = BinarySize::snapshotFile(binaryDir);
+	BinarySize baseline;
+	if (baseline.load(snapshotFile))
+	{
+		if (settings.sizeOfDist())
+			Helpers::info("Compare with the baseline stored by the last distribution: ", snapshotFile.data());
+		else
+			Helpers::info("Compare with the baseline stored by the last analysis of the build directory: ", snapshotFile.data());
+		BinarySize::printDiff(baseline, current, settings.reportEntries());
+	}
+	else if (settings.sizeOfDist())
+		Helpers::info("No baseline to compare with, the 'dist' command stores one in: ", snapshotFile.data());
+
+	// The distribution baseline is only replaced by the next distribution
+	if (settings.sizeOfDist() == false)
+	{
+		const std::string makeDirCommand = std::string("make_directory ") + BinarySize::snapshotsDir();
+		if (cmake.toolsMode(makeDirCommand.data()) == false || current.save(snapshotFile) == false)
+			Helpers::error("Cannot store the size of the binaries: ", snapshotFile.data());
+		else
+			Helpers::info("Store the baseline for the next analysis of the build directory: ", snapshotFile.data());
+	}
+}
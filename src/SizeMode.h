@@ -0,0 +1,10 @@
+#pragma once
+
+class CMakeCommand;
+class Settings;
+
+class SizeMode
+{
+  public:
+	static void perform(CMakeCommand &cmake, const Settings &settings);
+};
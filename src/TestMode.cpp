@@ -0,0 +1,537 @@
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "TestMode.h"
+#include "TestTimes.h"
+#include "GitCommand.h"
+#include "CMakeCommand.h"
+#include "NinjaDeps.h"
+#include "NinjaGraph.h"
+#include "JsonValue.h"
+#include "JobCount.h"
+#include "FileSystem.h"
+#include "Settings.h"
+#include "Configuration.h"
+#include "Process.h"
+#include "Helpers.h"
+
+namespace {
+
+/// Number of entries in the list of the slowest tests
+const unsigned int SummaryEntries = 5;
+/// The estimated duration of a test that has never been run, in milliseconds
+const unsigned int DefaultDuration = 1000;
+/// The commits of the last successful test run, kept in the build directory
+const char *testedHeadsFile = "ncline-tested-heads.tsv";
+
+struct TestInfo
+{
+	std::string name;
+	/// The executable of the test command, as specified by CTest
+	std::string executable;
+};
+
+struct TestResult
+{
+	std::string name;
+	/// Duration reported by CTest, in milliseconds
+	unsigned int duration = 0;
+	std::string status;
+	bool passed = false;
+};
+
+/// Parses the description of the tests printed by `ctest --show-only=json-v1`
+bool parseTestList(const std::string &output, std::vector<TestInfo> &tests)
+{
+	tests.clear();
+	JsonValue root;
+	if (JsonValue::parse(output, root) == false)
+		return false;
+
+	const JsonValue *testsArray = root.member("tests");
+	if (testsArray == nullptr || testsArray->isArray() == false)
+		return false;
+
+	for (const JsonValue &test : testsArray->elements())
+	{
+		TestInfo info;
+		info.name = test.stringMember("name");
+		const JsonValue *command = test.member("command");
+		if (command && command->isArray() && command->elements().empty() == false)
+			info.executable = command->elements().front().string();
+		if (info.name.empty() == false)
+			tests.push_back(info);
+	}
+
+	return true;
+}
+
+/// Parses a `1/3 Test #1: name ........   Passed    0.52 sec` line printed by CTest when a test finishes
+bool parseTestResult(const char *line, TestResult &result)
+{
+	const std::string string = Helpers::trim(line);
+	const char *suffix = " sec";
+	const size_t suffixLength = strlen(suffix);
+	if (string.size() <= suffixLength || string.compare(string.size() - suffixLength, suffixLength, suffix) != 0)
+		return false;
+
+	const size_t test = string.find("Test ");
+	const size_t number = (test != std::string::npos) ? string.find('#', test) : std::string::npos;
+	const size_t colon = (number != std::string::npos) ? string.find(": ", number) : std::string::npos;
+	if (colon == std::string::npos)
+		return false;
+
+	std::string rest = Helpers::trim(string.substr(colon + 2, string.size() - suffixLength - colon - 2));
+	const size_t space = rest.find_last_of(' ');
+	if (space == std::string::npos)
+		return false;
+	result.duration = static_cast<unsigned int>(strtod(rest.data() + space + 1, nullptr) * 1000.0 + 0.5);
+	rest = Helpers::trim(rest.substr(0, space));
+
+	// The name is padded with dots, the status follows them
+	const size_t dots = rest.find(" .");
+	if (dots == std::string::npos)
+		return false;
+	const size_t status = rest.find_first_not_of(". ", dots);
+	result.name = rest.substr(0, dots);
+	result.status = (status != std::string::npos) ? rest.substr(status) : std::string();
+	result.passed = (result.status.compare(0, 6, "Passed") == 0);
+
+	return true;
+}
+
+unsigned int estimatedDuration(const TestTimes &times, const std::string &target, const std::string &name)
+{
+	unsigned int duration = 0;
+	return times.duration(target, name, duration) ? duration : DefaultDuration;
+}
+
+/// Assigns every test to the shard with the lowest total duration so far, starting from the slowest test
+std::vector<std::string> selectShard(const std::vector<std::string> &names, const TestTimes &times, const std::string &target, unsigned int shardIndex, unsigned int numShards)
+{
+	if (numShards <= 1)
+		return names;
+
+	// Every worker has to compute the same partition, ties are resolved by name
+	std::vector<std::string> sortedNames(names);
+	std::sort(sortedNames.begin(), sortedNames.end(), [&](const std::string &a, const std::string &b) {
+		const unsigned int durationA = estimatedDuration(times, target, a);
+		const unsigned int durationB = estimatedDuration(times, target, b);
+		return (durationA != durationB) ? durationA > durationB : a < b;
+	});
+
+	std::vector<unsigned long int> shardDurations(numShards, 0);
+	std::vector<std::string> selected;
+	for (const std::string &name : sortedNames)
+	{
+		const unsigned int shard = static_cast<unsigned int>(std::min_element(shardDurations.begin(), shardDurations.end()) - shardDurations.begin());
+		shardDurations[shard] += estimatedDuration(times, target, name);
+		if (shard == shardIndex - 1)
+			selected.push_back(name);
+	}
+
+	return selected;
+}
+
+/// Returns an anchored regular expression that only matches the specified test names
+std::string namesRegex(const std::vector<std::string> &names)
+{
+	std::string regex = "^(";
+	for (unsigned int i = 0; i < names.size(); i++)
+	{
+		if (i > 0)
+			regex += '|';
+		for (const char c : names[i])
+		{
+			if (strchr("\\^$.|?*+()[]{}", c))
+				regex += '\\';
+			regex += c;
+		}
+	}
+	regex += ")$";
+	return regex;
+}
+
+/// Writes the recorded durations in the cost file of CTest, which starts the most expensive and the previously failed tests first
+void writeCostData(CMakeCommand &cmake, const std::string &buildDir, const std::vector<std::string> &names, const TestTimes &times, const std::string &target)
+{
+	const std::string temporaryDir = fs::joinPath(buildDir, "Testing/Temporary");
+	if (fs::isDirectory(temporaryDir.data()) == false)
+	{
+		const std::string makeDirCommand = "make_directory \"" + temporaryDir + "\"";
+		cmake.toolsMode(makeDirCommand.data());
+	}
+
+	std::ofstream file(fs::joinPath(temporaryDir, "CTestCostData.txt"), std::ios::trunc);
+	if (file.is_open() == false)
+		return;
+
+	std::vector<std::string> failedNames;
+	for (const std::string &name : names)
+	{
+		unsigned int duration = 0;
+		// The file is separated by spaces
+		if (name.find(' ') != std::string::npos || times.duration(target, name, duration) == false)
+			continue;
+
+		file << name << " 1 " << duration / 1000.0f << "\n";
+		if (times.failed(target, name))
+			failedNames.push_back(name);
+	}
+	file << "---\n";
+	for (const std::string &name : failedNames)
+		file << name << "\n";
+}
+
+bool isInside(const std::string &path, const std::string &directory)
+{
+	return (path.size() > directory.size() && path.compare(0, directory.size(), directory) == 0 && path[directory.size()] == '/');
+}
+
+/// A change to the build scripts can affect any test
+bool isCMakeFile(const std::string &path)
+{
+	return (fs::baseName(path.data()) == "CMakeLists.txt" || fs::endsWith(path, ".cmake") || fs::endsWith(path, ".cmake.in"));
+}
+
+/// The repositories whose changes can affect the tests of a target, starting from the one of the target
+std::vector<std::string> testedRepositories(const Settings &settings)
+{
+	std::vector<std::string> repositories;
+	if (settings.target() == Settings::Target::GAME)
+	{
+		std::string gameName;
+		config().gameName(gameName);
+		repositories.push_back(gameName);
+	}
+	repositories.push_back(Helpers::nCineSourceDir());
+	return repositories;
+}
+
+bool loadTestedHeads(const std::string &buildDir, std::unordered_map<std::string, std::string> &heads)
+{
+	std::ifstream file(fs::joinPath(buildDir, testedHeadsFile));
+	if (file.is_open() == false)
+		return false;
+
+	heads.clear();
+	std::string line;
+	while (std::getline(file, line))
+	{
+		if (line.empty() == false && line.back() == '\r')
+			line.pop_back();
+		const size_t tab = line.find('\t');
+		if (line.empty() == false && line[0] != '#' && tab != std::string::npos)
+			heads[line.substr(0, tab)] = line.substr(tab + 1);
+	}
+
+	return (heads.empty() == false);
+}
+
+void saveTestedHeads(GitCommand &git, const std::string &buildDir, const std::vector<std::string> &repositories)
+{
+	std::ofstream file(fs::joinPath(buildDir, testedHeadsFile), std::ios::trunc);
+	if (file.is_open() == false)
+		return;
+
+	for (const std::string &repository : repositories)
+	{
+		// A repository without a recorded commit will run all the tests the next time
+		std::string head;
+		if (git.retrieveHead(repository.data(), head))
+			file << repository << '\t' << head << "\n";
+	}
+}
+
+/// Removes the tests whose executables are not rebuilt by the changes since the last successful run, returns false if all the tests should run
+bool selectAffected(GitCommand &git, const CMakeCommand &cmake, const std::string &buildDir, const Settings &settings, std::vector<TestInfo> &tests)
+{
+	std::unordered_map<std::string, std::string> heads;
+	if (loadTestedHeads(buildDir, heads) == false)
+	{
+		Helpers::info("No successful test run has been recorded for the build directory, all the tests are run");
+		return false;
+	}
+	else if (config().withNinja() == false || cmake.ninjaFound() == false || CMakeCommand::generatorIsVisualStudio())
+	{
+		Helpers::info("The dependencies of the tests are only known when building with Ninja, all the tests are run");
+		return false;
+	}
+
+	NinjaDeps deps;
+	NinjaGraph graph;
+	if (deps.load(cmake.ninjaExecutable(), buildDir) == false || graph.load(buildDir) == false)
+	{
+		Helpers::info("Cannot read the Ninja dependencies of the build directory, all the tests are run");
+		return false;
+	}
+
+	const std::vector<std::string> repositories = testedRepositories(settings);
+	std::unordered_set<std::string> paths;
+	unsigned int numChangedFiles = 0;
+	for (unsigned int i = 0; i < repositories.size(); i++)
+	{
+		const std::string &repository = repositories[i];
+		auto headIt = heads.find(repository);
+		std::vector<std::string> files;
+		if (headIt == heads.end() || git.retrieveChangedFiles(repository.data(), headIt->second.data(), files) == false)
+		{
+			Helpers::info("Cannot compare the repository with the commit of the last successful test run, all the tests are run: ", repository.data());
+			return false;
+		}
+
+		const std::string repositoryDir = fs::normalizePath(fs::absolutePath(repository.data()));
+		for (const std::string &file : files)
+		{
+			// The sources of the engine are not dependencies of the game, but they change the library it links
+			if (isCMakeFile(file) || (i > 0 && fs::isSourceFile(file)))
+			{
+				Helpers::info("A change can affect every test, all the tests are run: ", fs::joinPath(repository, file).data());
+				return false;
+			}
+			paths.insert(fs::normalizePath(fs::joinPath(repositoryDir, file)));
+		}
+		numChangedFiles += static_cast<unsigned int>(files.size());
+	}
+
+	deps.addAffectedOutputs(paths);
+	graph.addAffectedOutputs(buildDir, paths);
+
+	const std::string absoluteBuildDir = fs::normalizePath(fs::absolutePath(buildDir.data()));
+	const size_t numTests = tests.size();
+	tests.erase(std::remove_if(tests.begin(), tests.end(), [&](const TestInfo &test) {
+		const std::string executable = fs::isAbsolute(test.executable) ? fs::normalizePath(test.executable)
+		                                                               : fs::normalizePath(fs::joinPath(absoluteBuildDir, test.executable));
+		// Commands that are not built by the project, like interpreters, always run
+		return (isInside(executable, absoluteBuildDir) && paths.count(executable) == 0);
+	}), tests.end());
+
+	const int MaxLength = 256;
+	char buffer[MaxLength];
+	snprintf(buffer, MaxLength, "%u changed files since the last successful run, %zu of %zu tests affected", numChangedFiles, tests.size(), numTests);
+	Helpers::info("Test impact: ", buffer);
+	return true;
+}
+
+std::string escapeJson(const std::string &string)
+{
+	std::string escaped;
+	for (const char c : string)
+	{
+		if (c == '"' || c == '\\')
+		{
+			escaped += '\\';
+			escaped += c;
+		}
+		else if (static_cast<unsigned char>(c) < 0x20)
+		{
+			char code[8];
+			snprintf(code, sizeof(code), "\\u%04x", static_cast<unsigned int>(c));
+			escaped += code;
+		}
+		else
+			escaped += c;
+	}
+	return escaped;
+}
+
+bool writeJUnit(const std::string &filename, const std::string &target, const std::vector<TestResult> &results, unsigned int numFailures, unsigned int wallTime)
+{
+	std::ofstream file(filename, std::ios::trunc);
+	if (file.is_open() == false)
+		return false;
+
+	file << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+	file << "<testsuite name=\"" << Helpers::escapeXml(target) << "\" tests=\"" << results.size() << "\" failures=\"" << numFailures
+	     << "\" time=\"" << wallTime / 1000.0f << "\">\n";
+	for (const TestResult &result : results)
+	{
+		file << "\t<testcase name=\"" << Helpers::escapeXml(result.name) << "\" classname=\"" << Helpers::escapeXml(target)
+		     << "\" time=\"" << result.duration / 1000.0f << "\"";
+		if (result.passed)
+			file << "/>\n";
+		else
+			file << ">\n\t\t<failure message=\"" << Helpers::escapeXml(result.status) << "\"/>\n\t</testcase>\n";
+	}
+	file << "</testsuite>\n";
+
+	return file.good();
+}
+
+bool writeJson(const std::string &filename, const std::string &target, const std::vector<TestResult> &results, unsigned int numFailures, unsigned int wallTime)
+{
+	std::ofstream file(filename, std::ios::trunc);
+	if (file.is_open() == false)
+		return false;
+
+	file << "{\n";
+	file << "\t\"target\": \"" << escapeJson(target) << "\",\n";
+	file << "\t\"tests\": " << results.size() << ",\n";
+	file << "\t\"failures\": " << numFailures << ",\n";
+	file << "\t\"wall_time\": " << wallTime / 1000.0f << ",\n";
+	file << "\t\"results\": [";
+	for (unsigned int i = 0; i < results.size(); i++)
+	{
+		const TestResult &result = results[i];
+		file << (i > 0 ? ",\n" : "\n") << "\t\t{ \"name\": \"" << escapeJson(result.name) << "\", \"status\": \"" << escapeJson(result.status)
+		     << "\", \"passed\": " << (result.passed ? "true" : "false") << ", \"time\": " << result.duration / 1000.0f << " }";
+	}
+	file << (results.empty() ? "]\n" : "\n\t]\n");
+	file << "}\n";
+
+	return file.good();
+}
+
+void printSummary(std::vector<TestResult> results, unsigned int numFailures, unsigned int wallTime)
+{
+	unsigned long int totalTime = 0;
+	for (const TestResult &result : results)
+		totalTime += result.duration;
+
+	const int MaxLength = 256;
+	char buffer[MaxLength];
+	snprintf(buffer, MaxLength, "%zu passed, %u failed, %.2f s wall time, %.2f s test time", results.size() - numFailures, numFailures,
+	         wallTime / 1000.0f, totalTime / 1000.0f);
+	Helpers::info("Tests: ", buffer);
+	if (results.empty())
+		return;
+
+	std::sort(results.begin(), results.end(), [](const TestResult &a, const TestResult &b) { return a.duration > b.duration; });
+	Helpers::info("Slowest tests:");
+	for (unsigned int i = 0; i < results.size() && i < SummaryEntries; i++)
+	{
+		snprintf(buffer, MaxLength, "%10.2f s  %s", results[i].duration / 1000.0f, results[i].name.data());
+		std::cout << buffer << "\n";
+	}
+	std::cout << std::flush;
+}
+
+}
+
+///////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////
+
+bool TestMode::perform(GitCommand &git, CMakeCommand &cmake, const Settings &settings)
+{
+	assert(settings.mode() == Settings::Mode::TEST);
+	assert(settings.target() != Settings::Target::LIBS);
+
+	if (config().platform() == Configuration::Platform::ANDROID)
+	{
+		Helpers::error("The tests of an Android build cannot run on the host");
+		return false;
+	}
+	else if (cmake.supportsTestDir() == false)
+	{
+		Helpers::error("The test mode needs at least CMake 3.20: ", cmake.executable().data());
+		return false;
+	}
+	else if (settings.numShards() == 0)
+	{
+		Helpers::error("Specify the shard as <index>/<count>, with an index starting from one");
+		return false;
+	}
+
+	const std::string buildDir = Helpers::targetBuildDir(settings);
+	if (fs::isDirectory(buildDir.data()) == false)
+	{
+		Helpers::error("Build the tests before running them, cannot find the build directory: ", buildDir.data());
+		return false;
+	}
+	const char *configName = CMakeCommand::generatorIsMultiConfig() ? Settings::buildTypeToConfigString(settings.buildType()) : nullptr;
+	const std::string target = Settings::targetToString(settings.target());
+
+	std::string output;
+	std::vector<TestInfo> tests;
+	if (cmake.listTests(buildDir.data(), configName, output) == false || parseTestList(output, tests) == false)
+	{
+		Helpers::error("Cannot list the tests of the build directory: ", buildDir.data());
+		return false;
+	}
+	else if (tests.empty())
+	{
+		Helpers::info("No tests found in the build directory: ", buildDir.data());
+		if (settings.target() == Settings::Target::ENGINE)
+			Helpers::info("Enable the engine tests with the 'set -cmake-args \"-D NCINE_BUILD_TESTS=ON\"' command and build again");
+		return true;
+	}
+
+	std::string jobsReason;
+	cmake.setJobs(JobCount::compute(settings.jobs(), jobsReason));
+	const int MaxLength = 256;
+	char buffer[MaxLength];
+	snprintf(buffer, MaxLength, "%u (%s)", cmake.jobs(), jobsReason.data());
+	Helpers::info("Number of parallel test jobs: ", buffer);
+
+	const unsigned int numTests = static_cast<unsigned int>(tests.size());
+	if (settings.allTests() == false)
+		selectAffected(git, cmake, buildDir, settings, tests);
+	std::vector<std::string> names;
+	for (const TestInfo &test : tests)
+		names.push_back(test.name);
+
+	TestTimes times;
+	times.load();
+	const std::vector<std::string> selectedNames = selectShard(names, times, target, settings.shardIndex(), settings.numShards());
+	if (settings.numShards() > 1)
+	{
+		snprintf(buffer, MaxLength, "%zu of %zu tests in shard %u/%u", selectedNames.size(), names.size(), settings.shardIndex(), settings.numShards());
+		Helpers::info("Run ", buffer);
+	}
+	if (times.empty() == false)
+		writeCostData(cmake, buildDir, selectedNames, times, target);
+
+	std::vector<TestResult> results;
+	unsigned int numFailures = 0;
+	const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+	bool executed = true;
+	if (selectedNames.empty() == false)
+	{
+		const std::string regex = (selectedNames.size() < numTests) ? namesRegex(selectedNames) : std::string();
+		executed = cmake.test(buildDir.data(), configName, regex.empty() ? nullptr : regex.data(), [&](const char *line) {
+			std::cout << line << std::flush;
+			TestResult result;
+			if (parseTestResult(line, result))
+			{
+				numFailures += result.passed ? 0 : 1;
+				results.push_back(result);
+			}
+		});
+	}
+	const unsigned int wallTime = static_cast<unsigned int>(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime).count());
+
+	if (Process::dryRun)
+		return true;
+	else if (executed == false && results.empty())
+	{
+		Helpers::error("Cannot run the tests in the build directory: ", buildDir.data());
+		return false;
+	}
+
+	for (const TestResult &result : results)
+		times.record(target, result.name, result.duration, result.passed == false);
+	if (times.save() == false)
+		Helpers::error("Cannot save the test durations: ", TestTimes::timesFile());
+
+	printSummary(results, numFailures, wallTime);
+	if (settings.junitFile().empty() == false && writeJUnit(settings.junitFile(), target, results, numFailures, wallTime) == false)
+		Helpers::error("Cannot write the JUnit summary: ", settings.junitFile().data());
+	if (settings.jsonFile().empty() == false && writeJson(settings.jsonFile(), target, results, numFailures, wallTime) == false)
+		Helpers::error("Cannot write the JSON summary: ", settings.jsonFile().data());
+
+	// The changes since a successful run of all the shards cannot be known by a single worker
+	const bool succeeded = (executed && numFailures == 0);
+	if (succeeded && settings.numShards() == 1)
+		saveTestedHeads(git, buildDir, testedRepositories(settings));
+
+	return succeeded;
+}
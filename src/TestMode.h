@@ -0,0 +1,12 @@
+#pragma once
+
+class Settings;
+class GitCommand;
+class CMakeCommand;
+
+class TestMode
+{
+  public:
+	/// Returns false if the tests could not be run or some of them failed
+	static bool perform(GitCommand &git, CMakeCommand &cmake, const Settings &settings);
+};
@@ -0,0 +1,94 @@
+#include <cstdlib>
+#include <fstream>
+#include "TestTimes.h"
+
+namespace {
+
+const char *header = "# ncline test times v1";
+const unsigned int NumFields = 4;
+
+bool splitFields(const std::string &line, std::string fields[NumFields])
+{
+	size_t start = 0;
+	for (unsigned int i = 0; i < NumFields - 1; i++)
+	{
+		const size_t tab = line.find('\t', start);
+		if (tab == std::string::npos)
+			return false;
+		fields[i] = line.substr(start, tab - start);
+		start = tab + 1;
+	}
+	fields[NumFields - 1] = line.substr(start);
+
+	return (fields[NumFields - 1].find('\t') == std::string::npos);
+}
+
+}
+
+///////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////
+
+bool TestTimes::load()
+{
+	std::ifstream file(timesFile());
+	if (file.is_open() == false)
+		return false;
+
+	tests_.clear();
+	std::string line;
+	std::string fields[NumFields];
+	while (std::getline(file, line))
+	{
+		if (line.empty() == false && line.back() == '\r')
+			line.pop_back();
+		if (line.empty() || line[0] == '#' || splitFields(line, fields) == false)
+			continue;
+
+		Test test;
+		test.duration = strtoul(fields[2].data(), nullptr, 10);
+		test.failed = (fields[3] == "failed");
+		tests_[std::make_pair(fields[0], fields[1])] = test;
+	}
+
+	return true;
+}
+
+bool TestTimes::save() const
+{
+	std::ofstream file(timesFile(), std::ios::trunc);
+	if (file.is_open() == false)
+		return false;
+
+	file << header << "\n";
+	for (const auto &pair : tests_)
+	{
+		file << pair.first.first << '\t' << pair.first.second << '\t' << pair.second.duration << '\t'
+		     << (pair.second.failed ? "failed" : "passed") << "\n";
+	}
+
+	return file.good();
+}
+
+bool TestTimes::duration(const std::string &target, const std::string &name, unsigned int &duration) const
+{
+	auto testIt = tests_.find(std::make_pair(target, name));
+	if (testIt == tests_.end())
+		return false;
+
+	duration = testIt->second.duration;
+	return true;
+}
+
+bool TestTimes::failed(const std::string &target, const std::string &name) const
+{
+	auto testIt = tests_.find(std::make_pair(target, name));
+	return (testIt != tests_.end() && testIt->second.failed);
+}
+
+void TestTimes::record(const std::string &target, const std::string &name, unsigned int duration, bool failed)
+{
+	Test &test = tests_[std::make_pair(target, name)];
+	test.duration = duration;
+	test.failed = failed;
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <string>
+#include <map>
+
+/// The durations and outcomes of the last run of every test, shared by all the targets
+class TestTimes
+{
+  public:
+	static const char *timesFile() { return "ncline-test-times.tsv"; }
+
+	bool load();
+	bool save() const;
+
+	inline bool empty() const { return tests_.empty(); }
+
+	/// Returns true if a test has been run before, with its duration in milliseconds
+	bool duration(const std::string &target, const std::string &name, unsigned int &duration) const;
+	/// Returns true if a test failed the last time it was run
+	bool failed(const std::string &target, const std::string &name) const;
+	void record(const std::string &target, const std::string &name, unsigned int duration, bool failed);
+
+  private:
+	struct Test
+	{
+		unsigned int duration = 0;
+		bool failed = false;
+	};
+
+	/// The tests ordered by target and name, to keep the file stable between runs
+	std::map<std::pair<std::string, std::string>, Test> tests_;
+};
@@ -0,0 +1,108 @@
+#include <cstdlib>
+#include <ctime>
+#include <mutex>
+#include <vector>
+#include "Trash.h"
+#include "CMakeCommand.h"
+#include "FileSystem.h"
+#include "Process.h"
+#include "Helpers.h"
+
+namespace {
+
+/// Directories can be cleaned by the concurrent configuration of several build types
+std::mutex mutex;
+/// A directory moved into the trash more recently can still be in the process of being removed by another command
+const time_t MinStaleSeconds = 15 * 60;
+
+/// The removal is not waited for, a directory left by an interrupted removal is found again by `Trash::emptyStale()`
+bool removeInBackground(CMakeCommand &cmake, const std::string &directory)
+{
+	const std::string command = cmake.executable() + " -E " + cmake.removeDir() + "\"" + directory + "\"";
+	return Process::startDetached(command.data());
+}
+
+/// Returns a path inside the trash that is not used yet
+std::string trashPath(const std::string &directory)
+{
+	const std::string basePath = fs::joinPath(Trash::trashDir(), fs::baseName(directory.data())) + "-" + std::to_string(time(nullptr));
+	std::string path = basePath;
+	for (unsigned int i = 1; fs::exists(path.data()); i++)
+		path = basePath + "-" + std::to_string(i);
+	return path;
+}
+
+/// Returns the time a directory was moved into the trash, as recorded in its name by `trashPath()`, or zero if not found
+time_t trashTime(const std::string &path)
+{
+	std::string name = fs::baseName(path.data());
+	// A counter can follow the time, timestamps are much larger numbers
+	for (unsigned int i = 0; i < 2; i++)
+	{
+		const size_t separator = name.rfind('-');
+		if (separator == std::string::npos)
+			break;
+
+		const long long int value = strtoll(name.data() + separator + 1, nullptr, 10);
+		if (value > 1000000000LL)
+			return static_cast<time_t>(value);
+		name.erase(separator);
+	}
+
+	return 0;
+}
+
+}
+
+///////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////
+
+bool Trash::removeDir(CMakeCommand &cmake, const std::string &directory)
+{
+	const std::string removeCommand = cmake.removeDir() + ("\"" + directory + "\"");
+	if (Process::dryRun)
+		return cmake.toolsMode(removeCommand.data());
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+
+		// Renaming is instant on the same file system, while removing can take longer than configuring again
+		const std::string makeDirCommand = std::string("make_directory ") + trashDir();
+		const std::string path = trashPath(directory);
+		if ((fs::exists(trashDir()) || cmake.toolsMode(makeDirCommand.data())) && fs::rename(directory.data(), path.data()))
+		{
+			Helpers::info("Remove in the background: ", path.data());
+			if (removeInBackground(cmake, path) == false)
+				Helpers::error("Cannot start the background removal, the directory is left in the trash: ", path.data());
+			return true;
+		}
+	}
+
+	return cmake.toolsMode(removeCommand.data());
+}
+
+void Trash::emptyStale(CMakeCommand &cmake)
+{
+	std::vector<std::string> entries;
+	if (Process::dryRun || fs::listEntries(trashDir(), entries) == false || entries.empty())
+		return;
+
+	std::lock_guard<std::mutex> lock(mutex);
+	const time_t now = time(nullptr);
+	bool anyStale = false;
+	for (const std::string &entry : entries)
+	{
+		// Removing the same directory twice would make both removals fail on the files deleted by the other one
+		if (now - trashTime(entry) < MinStaleSeconds)
+			continue;
+
+		if (anyStale == false)
+		{
+			Helpers::info("Remove in the background the directories left in the trash: ", trashDir());
+			anyStale = true;
+		}
+		if (removeInBackground(cmake, entry) == false)
+			Helpers::error("Cannot start the background removal of: ", entry.data());
+	}
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <string>
+
+class CMakeCommand;
+
+/// Removes directories in detached processes after moving them out of the way
+class Trash
+{
+  public:
+	/// Returns the directory that keeps the moved directories until they are removed
+	static const char *trashDir() { return "ncline-trash"; }
+
+	/// Moves a directory into the trash and starts removing it in the background, or removes it in place if it cannot be moved
+	static bool removeDir(CMakeCommand &cmake, const std::string &directory);
+	/// Starts removing the directories left in the trash by an interrupted removal, skipping the ones moved there recently
+	static void emptyStale(CMakeCommand &cmake);
+};
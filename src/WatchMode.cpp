@@ -0,0 +1,152 @@
+#include <cassert>
+#include <cstdio>
+#include <vector>
+#include "WatchMode.h"
+#include "CMakeCommand.h"
+#include "FileWatcher.h"
+#include "JobCount.h"
+#include "FileSystem.h"
+#include "Settings.h"
+#include "Configuration.h"
+#include "Helpers.h"
+
+namespace {
+
+void watchDirectory(FileWatcher &watcher, const std::string &directory, Settings::Target target, std::vector<Settings::Target> &watchedTargets)
+{
+	// A data repository is optional
+	if (fs::isDirectory(directory.data()) == false)
+		return;
+
+	if (watcher.addDirectory(directory))
+		Helpers::info("Watch the directory: ", directory.data());
+	watchedTargets.push_back(target);
+}
+
+bool build(CMakeCommand &cmake, const std::string &buildDir, const Settings &settings)
+{
+	if (CMakeCommand::generatorIsMultiConfig())
+		return cmake.buildConfig(buildDir.data(), Settings::buildTypeToConfigString(settings.buildType()));
+	else
+		return cmake.build(buildDir.data());
+}
+
+}
+
+///////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////
+
+void WatchMode::perform(CMakeCommand &cmake, const Settings &settings)
+{
+	assert(settings.mode() == Settings::Mode::WATCH);
+	assert(settings.target() != Settings::Target::LIBS);
+
+	if (FileWatcher::isSupported() == false)
+	{
+		Helpers::error("The watch mode is only available on Linux");
+		return;
+	}
+
+	std::string jobsReason;
+	cmake.setJobs(JobCount::compute(settings.jobs(), jobsReason));
+
+	if (config().platform() == Configuration::Platform::ANDROID)
+	{
+		cmake.addNMakeDirToPath();
+		// Needed by Gradle to strip libraries
+		cmake.addAndroidNdkDirToPath();
+		cmake.addAndroidSdkDirToPath();
+	}
+
+	const bool withEngine = (settings.target() == Settings::Target::ENGINE || settings.watchEngine());
+	std::string gameName;
+	if (settings.target() == Settings::Target::GAME)
+		config().gameName(gameName);
+
+	std::string engineBuildDir = Helpers::nCineSourceDir();
+	Helpers::buildDir(engineBuildDir, settings);
+	std::string gameBuildDir = gameName;
+	Helpers::buildDir(gameBuildDir, settings);
+
+	// Only incremental builds are run, the build directories need to be configured beforehand
+	if (withEngine && fs::isDirectory(engineBuildDir.data()) == false)
+	{
+		Helpers::error("Configure the engine before watching it, cannot find the build directory: ", engineBuildDir.data());
+		return;
+	}
+	if (gameName.empty() == false && fs::isDirectory(gameBuildDir.data()) == false)
+	{
+		Helpers::error("Configure the game before watching it, cannot find the build directory: ", gameBuildDir.data());
+		return;
+	}
+
+	FileWatcher watcher;
+	// The target of every watched directory, in the order of addition
+	std::vector<Settings::Target> watchedTargets;
+	if (withEngine)
+	{
+		watchDirectory(watcher, Helpers::nCineSourceDir(), Settings::Target::ENGINE, watchedTargets);
+		if (settings.target() == Settings::Target::ENGINE)
+			watchDirectory(watcher, Helpers::nCineDataSourceDir(), Settings::Target::ENGINE, watchedTargets);
+	}
+	if (gameName.empty() == false)
+	{
+		watchDirectory(watcher, gameName, Settings::Target::GAME, watchedTargets);
+		watchDirectory(watcher, Helpers::gameDataSourceDir(gameName), Settings::Target::GAME, watchedTargets);
+	}
+
+	if (watcher.numWatches() == 0)
+	{
+		Helpers::error("No directory to watch");
+		return;
+	}
+
+	const int MaxLength = 256;
+	char buffer[MaxLength];
+	snprintf(buffer, MaxLength, "%u directories, press Ctrl+C to stop", watcher.numWatches());
+	Helpers::info("Waiting for changes: ", buffer);
+
+	// Builds run synchronously: the changes notified in the meantime are queued and coalesced in the next batch
+	std::vector<bool> changedDirs;
+	for (;;)
+	{
+		const unsigned int numChanges = watcher.waitForChanges(settings.debounceTime(), changedDirs);
+		if (numChanges == 0)
+		{
+			Helpers::error("Cannot read the file change notifications");
+			break;
+		}
+
+		bool engineChanged = false;
+		bool gameChanged = false;
+		for (unsigned int i = 0; i < changedDirs.size(); i++)
+		{
+			if (changedDirs[i] && watchedTargets[i] == Settings::Target::ENGINE)
+				engineChanged = true;
+			else if (changedDirs[i] && watchedTargets[i] == Settings::Target::GAME)
+				gameChanged = true;
+		}
+
+		snprintf(buffer, MaxLength, "%u", numChanges);
+		Helpers::info("Changed files: ", buffer);
+
+		bool hasBuilt = true;
+		if (engineChanged)
+		{
+			Helpers::info("Build the engine");
+			hasBuilt = build(cmake, engineBuildDir, settings);
+		}
+		// A game is relinked against a rebuilt engine
+		if (hasBuilt && gameName.empty() == false && (gameChanged || engineChanged))
+		{
+			Helpers::info("Build the game: ", gameName.data());
+			hasBuilt = build(cmake, gameBuildDir, settings);
+		}
+
+		if (hasBuilt == false)
+			Helpers::error("The build has failed, waiting for the next change");
+		else
+			Helpers::info("Waiting for changes");
+	}
+}
@@ -0,0 +1,10 @@
+#pragma once
+
+class Settings;
+class CMakeCommand;
+
+class WatchMode
+{
+  public:
+	static void perform(CMakeCommand &cmake, const Settings &settings);
+};
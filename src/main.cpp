@@ -2,16 +2,28 @@
 #include "Settings.h"
 #include "GitCommand.h"
 #include "CMakeCommand.h"
+#include "CacheCommand.h"
 #include "Process.h"
 #include "Helpers.h"
+#include "Trash.h"
 
 #include "DownloadMode.h"
 #include "ConfMode.h"
 #include "BuildMode.h"
 #include "DistMode.h"
+#include "ReportMode.h"
+#include "HistoryMode.h"
+#include "AnalyzeMode.h"
+#include "WatchMode.h"
+#include "PgoMode.h"
+#include "TestMode.h"
+#include "BenchMode.h"
+#include "ProfileMode.h"
+#include "SizeMode.h"
 
 int main(int argc, char **argv)
 {
+	int exitCode = EXIT_SUCCESS;
 	Settings settings;
 	const bool parsed = settings.parseArguments(argc, argv);
 	if (parsed == false)
@@ -63,6 +75,29 @@ int main(int argc, char **argv)
 				Helpers::error("Cannot find Ninja executable: ", cmake.ninjaExecutable().data());
 			else
 				Helpers::info("Ninja executable found: ", cmake.ninjaExecutable().data());
+
+			if (config().withNinjaMultiConfig() && cmake.found() && cmake.supportsNinjaMultiConfig() == false)
+				Helpers::error("The Ninja Multi-Config generator needs at least CMake 3.17, the Ninja one will be used: ", cmake.executable().data());
+		}
+
+		if (config().linker() != Configuration::Linker::DEFAULT)
+		{
+			if (cmake.linkerFound() == false)
+				Helpers::error("Cannot find linker executable, the default one will be used: ", cmake.linkerExecutable().data());
+			else
+				Helpers::info("Linker executable found: ", cmake.linkerExecutable().data());
+		}
+
+		CacheCommand cache;
+		if (cache.enabled())
+		{
+			if (cache.found() == false)
+				Helpers::error("Cannot find compiler cache executable: ", cache.executable().data());
+			else
+			{
+				Helpers::info("Compiler cache executable found: ", cache.executable().data());
+				cache.setupEnvironment();
+			}
 		}
 
 		bool gameNameIsMissing = false;
@@ -75,16 +110,37 @@ int main(int argc, char **argv)
 
 		if (git.found() && cmake.found() && gameNameIsMissing == false)
 		{
+			Trash::emptyStale(cmake);
+
 			switch (settings.mode())
 			{
 				case Settings::Mode::DOWNLOAD: DownloadMode::perform(git, cmake, settings); break;
-				case Settings::Mode::CONF: ConfMode::perform(cmake, settings); break;
-				case Settings::Mode::BUILD: BuildMode::perform(cmake, settings); break;
-				case Settings::Mode::DIST: DistMode::perform(cmake, settings); break;
+				case Settings::Mode::CONF: ConfMode::perform(cmake, cache, settings); break;
+				case Settings::Mode::BUILD: BuildMode::perform(git, cmake, cache, settings); break;
+				case Settings::Mode::DIST: DistMode::perform(git, cmake, cache, settings); break;
+				case Settings::Mode::REPORT: ReportMode::perform(cmake, settings); break;
+				case Settings::Mode::HISTORY: HistoryMode::perform(settings); break;
+				case Settings::Mode::ANALYZE: AnalyzeMode::perform(cmake, cache, settings); break;
+				case Settings::Mode::WATCH: WatchMode::perform(cmake, settings); break;
+				case Settings::Mode::PGO: PgoMode::perform(git, cmake, cache, settings); break;
+				case Settings::Mode::TEST:
+					// Continuous integration scripts rely on the exit code to detect failing tests
+					if (TestMode::perform(git, cmake, settings) == false)
+						exitCode = EXIT_FAILURE;
+					break;
+				case Settings::Mode::BENCH:
+					if (BenchMode::perform(git, cmake, cache, settings) == false)
+						exitCode = EXIT_FAILURE;
+					break;
+				case Settings::Mode::PROFILE:
+					if (ProfileMode::perform(cmake, settings) == false)
+						exitCode = EXIT_FAILURE;
+					break;
+				case Settings::Mode::SIZE: SizeMode::perform(cmake, settings); break;
 				default: break;
 			}
 		}
 	}
 
-	return EXIT_SUCCESS;
+	return exitCode;
 }